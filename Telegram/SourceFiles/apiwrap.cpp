@@ -99,6 +99,8 @@ constexpr auto kForwardMessagesOnAdd = 100;
 constexpr auto kTopPromotionInterval = TimeId(60 * 60);
 constexpr auto kTopPromotionMinDelay = TimeId(10);
 constexpr auto kSmallDelayMs = 5;
+constexpr auto kMessageDataResolveDelay = crl::time(20);
+constexpr auto kMessageDataPerRequest = 100;
 constexpr auto kUnreadMentionsPreloadIfLess = 5;
 constexpr auto kUnreadMentionsFirstRequestLimit = 10;
 constexpr auto kUnreadMentionsNextRequestLimit = 100;
@@ -181,7 +183,7 @@ bool ApiWrap::BlockedPeersSlice::operator!=(const BlockedPeersSlice &other) cons
 ApiWrap::ApiWrap(not_null<Main::Session*> session)
 : MTP::Sender(&session->account().mtp())
 , _session(session)
-, _messageDataResolveDelayed([=] { resolveMessageDatas(); })
+, _messageDataResolveTimer([=] { resolveMessageDatas(); })
 , _webPagesTimer([=] { resolveWebPages(); })
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
@@ -563,21 +565,22 @@ void ApiWrap::sendMessageFail(
 }
 
 void ApiWrap::requestMessageData(ChannelData *channel, MsgId msgId, RequestMessageDataCallback callback) {
-	auto &req = (channel ? _channelMessageDataRequests[channel][msgId] : _messageDataRequests[msgId]);
+	auto &requests = channel
+		? _channelMessageDataRequests[channel]
+		: _messageDataRequests;
+	++_messageDataLookups;
+	if (requests.contains(msgId)) {
+		++_messageDataJoined;
+	}
+	auto &req = requests[msgId];
 	if (callback) {
 		req.callbacks.append(callback);
 	}
-	if (!req.requestId) _messageDataResolveDelayed.call();
-}
 
-QVector<MTPInputMessage> ApiWrap::collectMessageIds(const MessageDataRequests &requests) {
-	auto result = QVector<MTPInputMessage>();
-	result.reserve(requests.size());
-	for (auto i = requests.cbegin(), e = requests.cend(); i != e; ++i) {
-		if (i.value().requestId > 0) continue;
-		result.push_back(MTP_inputMessageID(MTP_int(i.key())));
+	// Lookups from all the chats within a short window share requests.
+	if (!req.requestId && !_messageDataResolveTimer.isActive()) {
+		_messageDataResolveTimer.callOnce(kMessageDataResolveDelay);
 	}
-	return result;
 }
 
 ApiWrap::MessageDataRequests *ApiWrap::messageDataRequests(ChannelData *channel, bool onlyExisting) {
@@ -597,43 +600,66 @@ ApiWrap::MessageDataRequests *ApiWrap::messageDataRequests(ChannelData *channel,
 void ApiWrap::resolveMessageDatas() {
 	if (_messageDataRequests.isEmpty() && _channelMessageDataRequests.isEmpty()) return;
 
-	auto ids = collectMessageIds(_messageDataRequests);
-	if (!ids.isEmpty()) {
-		auto requestId = request(MTPmessages_GetMessages(
-			MTP_vector<MTPInputMessage>(ids)
-		)).done([this](const MTPmessages_Messages &result, mtpRequestId requestId) {
-			gotMessageDatas(nullptr, result, requestId);
-		}).fail([this](const RPCError &error, mtpRequestId requestId) {
-			finalizeMessageDataRequest(nullptr, requestId);
-		}).afterDelay(kSmallDelayMs).send();
-		for (auto &request : _messageDataRequests) {
-			if (request.requestId > 0) continue;
-			request.requestId = requestId;
-		}
-	}
+	const auto wasSent = _messageDataRequestsSent;
+	sendMessageDataRequests(nullptr, _messageDataRequests);
 	for (auto j = _channelMessageDataRequests.begin(); j != _channelMessageDataRequests.cend();) {
 		if (j->isEmpty()) {
 			j = _channelMessageDataRequests.erase(j);
 			continue;
 		}
-		auto ids = collectMessageIds(j.value());
-		if (!ids.isEmpty()) {
-			auto channel = j.key();
-			auto requestId = request(MTPchannels_GetMessages(
-				j.key()->inputChannel,
+		sendMessageDataRequests(j.key(), j.value());
+		++j;
+	}
+	if (_messageDataRequestsSent != wasSent) {
+		DEBUG_LOG(("API Info: message data lookups %1, joined %2, "
+			"requests sent %3."
+			).arg(_messageDataLookups
+			).arg(_messageDataJoined
+			).arg(_messageDataRequestsSent));
+	}
+}
+
+void ApiWrap::sendMessageDataRequests(
+		ChannelData *channel,
+		MessageDataRequests &requests) {
+	auto ids = QVector<MTPInputMessage>();
+	auto waiting = std::vector<not_null<MessageDataRequest*>>();
+	const auto send = [&] {
+		const auto requestId = channel
+			? request(MTPchannels_GetMessages(
+				channel->inputChannel,
 				MTP_vector<MTPInputMessage>(ids)
 			)).done([=](const MTPmessages_Messages &result, mtpRequestId requestId) {
 				gotMessageDatas(channel, result, requestId);
 			}).fail([=](const RPCError &error, mtpRequestId requestId) {
 				finalizeMessageDataRequest(channel, requestId);
+			}).afterDelay(kSmallDelayMs).send()
+			: request(MTPmessages_GetMessages(
+				MTP_vector<MTPInputMessage>(ids)
+			)).done([=](const MTPmessages_Messages &result, mtpRequestId requestId) {
+				gotMessageDatas(nullptr, result, requestId);
+			}).fail([=](const RPCError &error, mtpRequestId requestId) {
+				finalizeMessageDataRequest(nullptr, requestId);
 			}).afterDelay(kSmallDelayMs).send();
-
-			for (auto &request : *j) {
-				if (request.requestId > 0) continue;
-				request.requestId = requestId;
-			}
+		for (const auto request : waiting) {
+			request->requestId = requestId;
+		}
+		++_messageDataRequestsSent;
+		ids.clear();
+		waiting.clear();
+	};
+	for (auto i = requests.begin(), e = requests.end(); i != e; ++i) {
+		if (i.value().requestId > 0) {
+			continue;
+		}
+		ids.push_back(MTP_inputMessageID(MTP_int(i.key())));
+		waiting.push_back(&i.value());
+		if (ids.size() == kMessageDataPerRequest) {
+			send();
 		}
-		++j;
+	}
+	if (!ids.isEmpty()) {
+		send();
 	}
 }
 
@@ -3569,6 +3595,9 @@ void ApiWrap::sharedMediaDone(
 		parsed.noSkipRange,
 		parsed.fullCount
 	));
+	if (parsed.fullCount) {
+		local().setSharedMediaCountHint(peer->id, type, *parsed.fullCount);
+	}
 	if (type == SharedMediaType::Pinned && !parsed.messageIds.empty()) {
 		peer->setHasPinnedMessages(true);
 	}
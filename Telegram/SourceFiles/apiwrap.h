@@ -521,7 +521,9 @@ private:
 		ChannelData *channel,
 		mtpRequestId requestId);
 
-	QVector<MTPInputMessage> collectMessageIds(const MessageDataRequests &requests);
+	void sendMessageDataRequests(
+		ChannelData *channel,
+		MessageDataRequests &requests);
 	MessageDataRequests *messageDataRequests(ChannelData *channel, bool onlyExisting = false);
 
 	void gotChatFull(
@@ -666,7 +668,10 @@ private:
 
 	MessageDataRequests _messageDataRequests;
 	QMap<ChannelData*, MessageDataRequests> _channelMessageDataRequests;
-	SingleQueuedInvokation _messageDataResolveDelayed;
+	base::Timer _messageDataResolveTimer;
+	int _messageDataLookups = 0;
+	int _messageDataJoined = 0;
+	int _messageDataRequestsSent = 0;
 
 	using PeerRequests = QMap<PeerData*, mtpRequestId>;
 	PeerRequests _fullPeerRequests;
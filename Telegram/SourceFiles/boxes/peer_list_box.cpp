@@ -444,21 +444,28 @@ bool PeerListRow::checked() const {
 }
 
 void PeerListRow::setCustomStatus(const QString &status, bool active) {
-	setStatusText(status);
+	_customStatus = status;
 	_statusType = active ? StatusType::CustomActive : StatusType::Custom;
 	_statusValidTill = 0;
+	if (_initialized) {
+		setStatusText(status);
+	}
 }
 
 void PeerListRow::clearCustomStatus() {
+	_customStatus = QString();
 	_statusType = StatusType::Online;
 	refreshStatus();
 }
 
 void PeerListRow::refreshStatus() {
-	if (!_initialized
-		|| special()
-		|| _statusType == StatusType::Custom
+	if (!_initialized) {
+		return;
+	} else if (_statusType == StatusType::Custom
 		|| _statusType == StatusType::CustomActive) {
+		setStatusText(_customStatus);
+		return;
+	} else if (special()) {
 		return;
 	}
 	_statusType = StatusType::LastSeen;
@@ -679,6 +686,17 @@ void PeerListRow::lazyInitialize(const style::PeerListItem &st) {
 	refreshStatus();
 }
 
+void PeerListRow::releaseLazyState() {
+	if (!_initialized) {
+		return;
+	}
+	_initialized = false;
+	_name = Ui::Text::String();
+	_status = Ui::Text::String();
+	_statusValidTill = 0;
+	_userpic = nullptr;
+}
+
 void PeerListRow::createCheckbox(
 		const style::RoundImageCheckbox &st,
 		Fn<void()> updateCallback) {
@@ -807,6 +825,7 @@ void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
 	}
 
 	removeFromSearchIndex(row);
+	clearLocalSearchCache();
 	row->setNameFirstLetters(row->peer()->nameFirstLetters());
 	for (auto ch : row->nameFirstLetters()) {
 		_searchIndex[ch].push_back(row);
@@ -827,6 +846,7 @@ void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 			}
 		}
 		row->setNameFirstLetters({});
+		clearLocalSearchCache();
 	}
 }
 
@@ -900,6 +920,7 @@ void PeerListContent::removeRow(not_null<PeerListRow*> row) {
 		byPeer.erase(ranges::remove(byPeer, row), end(byPeer));
 	}
 	removeFromSearchIndex(row);
+	_initializedRows.remove(row);
 	_filterResults.erase(
 		ranges::remove(_filterResults, row),
 		end(_filterResults));
@@ -918,8 +939,10 @@ void PeerListContent::clearAllContent() {
 	_lastMousePosition = std::nullopt;
 	_rowsById.clear();
 	_rowsByPeer.clear();
+	_initializedRows.clear();
 	_filterResults.clear();
 	_searchIndex.clear();
+	clearLocalSearchCache();
 	_rows.clear();
 	_searchRows.clear();
 	_searchQuery
@@ -1013,6 +1036,7 @@ void PeerListContent::refreshRows() {
 	if (_visibleBottom > 0) {
 		checkScrollForPreload();
 	}
+	releaseHiddenRows();
 	if (_mouseSelection) {
 		selectByMouse(QCursor::pos());
 	}
@@ -1249,6 +1273,7 @@ crl::time PeerListContent::paintRow(
 	Assert(row != nullptr);
 
 	row->lazyInitialize(_st.item);
+	_initializedRows.emplace(row);
 
 	auto refreshStatusAt = row->refreshStatusTime();
 	if (refreshStatusAt >= 0 && ms >= refreshStatusAt) {
@@ -1462,52 +1487,84 @@ void PeerListContent::searchQueryChanged(QString query) {
 	if (_normalizedSearchQuery != normalizedQuery) {
 		setSearchQuery(query, normalizedQuery);
 		if (_controller->searchInLocal() && !searchWordsList.isEmpty()) {
-			auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
-			for (const auto &searchWord : searchWordsList) {
-				auto searchWordStart = searchWord[0].toLower();
-				auto it = _searchIndex.find(searchWordStart);
-				if (it == _searchIndex.cend()) {
-					// Some word can't be found in any row.
-					minimalList = nullptr;
-					break;
-				} else if (!minimalList || minimalList->size() > it->second.size()) {
-					minimalList = &it->second;
+			filterLocalRows(searchWordsList);
+		}
+		if (_controller->hasComplexSearch()) {
+			_controller->search(_searchQuery);
+		}
+		refreshRows();
+	}
+}
+
+bool PeerListContent::localSearchNarrows(
+		const QStringList &searchWordsList) const {
+	// Each previous word is a prefix of the new word at the same place,
+	// so every row matching the new query matched the previous one too.
+	if (_localSearchWords.isEmpty()
+		|| _localSearchWords.size() > searchWordsList.size()) {
+		return false;
+	}
+	for (auto i = 0, count = int(_localSearchWords.size()); i != count; ++i) {
+		if (!searchWordsList[i].startsWith(_localSearchWords[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void PeerListContent::filterLocalRows(const QStringList &searchWordsList) {
+	auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
+	if (localSearchNarrows(searchWordsList)) {
+		minimalList = &_localSearchResults;
+	} else {
+		for (const auto &searchWord : searchWordsList) {
+			auto searchWordStart = searchWord[0].toLower();
+			auto it = _searchIndex.find(searchWordStart);
+			if (it == _searchIndex.cend()) {
+				// Some word can't be found in any row.
+				minimalList = nullptr;
+				break;
+			} else if (!minimalList
+				|| minimalList->size() > it->second.size()) {
+				minimalList = &it->second;
+			}
+		}
+	}
+	if (minimalList) {
+		auto searchWordInNames = [](
+				not_null<PeerData*> peer,
+				const QString &searchWord) {
+			for (auto &nameWord : peer->nameWords()) {
+				if (nameWord.startsWith(searchWord)) {
+					return true;
 				}
 			}
-			if (minimalList) {
-				auto searchWordInNames = [](
-						not_null<PeerData*> peer,
-						const QString &searchWord) {
-					for (auto &nameWord : peer->nameWords()) {
-						if (nameWord.startsWith(searchWord)) {
-							return true;
-						}
-					}
+			return false;
+		};
+		auto allSearchWordsInNames = [&](
+				not_null<PeerData*> peer) {
+			for (const auto &searchWord : searchWordsList) {
+				if (!searchWordInNames(peer, searchWord)) {
 					return false;
-				};
-				auto allSearchWordsInNames = [&](
-						not_null<PeerData*> peer) {
-					for (const auto &searchWord : searchWordsList) {
-						if (!searchWordInNames(peer, searchWord)) {
-							return false;
-						}
-					}
-					return true;
-				};
-
-				_filterResults.reserve(minimalList->size());
-				for (const auto row : *minimalList) {
-					if (!row->special() && allSearchWordsInNames(row->peer())) {
-						_filterResults.push_back(row);
-					}
 				}
 			}
+			return true;
+		};
+
+		_filterResults.reserve(minimalList->size());
+		for (const auto row : *minimalList) {
+			if (!row->special() && allSearchWordsInNames(row->peer())) {
+				_filterResults.push_back(row);
+			}
 		}
-		if (_controller->hasComplexSearch()) {
-			_controller->search(_searchQuery);
-		}
-		refreshRows();
 	}
+	_localSearchWords = searchWordsList;
+	_localSearchResults = _filterResults;
+}
+
+void PeerListContent::clearLocalSearchCache() {
+	_localSearchWords.clear();
+	_localSearchResults.clear();
 }
 
 std::unique_ptr<PeerListState> PeerListContent::saveState() const {
@@ -1586,6 +1643,43 @@ void PeerListContent::visibleTopBottomUpdated(
 	_visibleBottom = visibleBottom;
 	loadProfilePhotos();
 	checkScrollForPreload();
+	releaseHiddenRows();
+}
+
+void PeerListContent::releaseHiddenRows() {
+	if (_initializedRows.empty() || _visibleTop >= _visibleBottom) {
+		return;
+	}
+
+	// Keep the rows in a few screens around the visible ones, so that
+	// scrolling back and forth doesn't rebuild them all the time.
+	const auto keep = (_visibleBottom - _visibleTop) * PreloadHeightsCount;
+	const auto count = shownRowsCount();
+	const auto rowsTopCached = rowsTop();
+	const auto from = floorclamp(
+		_visibleTop - rowsTopCached - keep,
+		_rowHeight,
+		0,
+		count);
+	const auto till = ceilclamp(
+		_visibleBottom - rowsTopCached + keep,
+		_rowHeight,
+		0,
+		count);
+	auto kept = std::vector<not_null<PeerListRow*>>();
+	kept.reserve(std::max(till - from, 0));
+	for (auto index = from; index < till; ++index) {
+		kept.push_back(getRow(RowIndex(index)));
+	}
+	ranges::sort(kept);
+	for (auto i = begin(_initializedRows); i != end(_initializedRows);) {
+		if (ranges::binary_search(kept, *i)) {
+			++i;
+		} else {
+			(*i)->releaseLazyState();
+			i = _initializedRows.erase(i);
+		}
+	}
 }
 
 void PeerListContent::setSelected(Selected selected) {
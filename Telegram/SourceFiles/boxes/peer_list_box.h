@@ -195,6 +195,11 @@ public:
 	}
 
 	virtual void lazyInitialize(const style::PeerListItem &st);
+
+	// Frees the texts and the userpic view of a row scrolled far away,
+	// they will be created again by lazyInitialize() when needed.
+	void releaseLazyState();
+
 	virtual void paintStatusText(
 		Painter &p,
 		const style::PeerListItem &st,
@@ -231,6 +236,7 @@ private:
 	std::unique_ptr<Ui::RoundImageCheckbox> _checkbox;
 	Ui::Text::String _name;
 	Ui::Text::String _status;
+	QString _customStatus;
 	StatusType _statusType = StatusType::Online;
 	crl::time _statusValidTill = 0;
 	base::flat_set<QChar> _nameFirstLetters;
@@ -540,7 +546,9 @@ public:
 		for (auto &searchEntity : _searchIndex) {
 			callback(searchEntity.second.begin(), searchEntity.second.end());
 		}
+		clearLocalSearchCache();
 		refreshIndices();
+		releaseHiddenRows();
 		update();
 	}
 
@@ -622,6 +630,7 @@ private:
 	void selectByMouse(QPoint globalPosition);
 	void loadProfilePhotos();
 	void checkScrollForPreload();
+	void releaseHiddenRows();
 
 	void updateRow(not_null<PeerListRow*> row, RowIndex hint);
 	void updateRow(RowIndex row);
@@ -637,6 +646,10 @@ private:
 	bool addingToSearchIndex() const;
 	void removeFromSearchIndex(not_null<PeerListRow*> row);
 	void setSearchQuery(const QString &query, const QString &normalizedQuery);
+	void filterLocalRows(const QStringList &searchWordsList);
+	[[nodiscard]] bool localSearchNarrows(
+		const QStringList &searchWordsList) const;
+	void clearLocalSearchCache();
 	bool showingSearch() const {
 		return !_searchQuery.isEmpty();
 	}
@@ -664,6 +677,8 @@ private:
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
 
+	base::flat_set<not_null<PeerListRow*>> _initializedRows;
+
 	Selected _selected;
 	Selected _pressed;
 	Selected _contexted;
@@ -683,6 +698,10 @@ private:
 	QString _mentionHighlight;
 	std::vector<not_null<PeerListRow*>> _filterResults;
 
+	// Last local search, reused when the query is only being extended.
+	QStringList _localSearchWords;
+	std::vector<not_null<PeerListRow*>> _localSearchResults;
+
 	int _aboveHeight = 0;
 	int _belowHeight = 0;
 	object_ptr<TWidget> _aboveWidget = { nullptr };
@@ -22,6 +22,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/launcher.h"
 #include "core/ui_integration.h"
 #include "core/core_settings.h"
+#include "core/core_startup_trace.h"
 #include "chat_helpers/emoji_keywords.h"
 #include "chat_helpers/stickers_emoji_image_loader.h"
 #include "base/platform/base_platform_info.h"
@@ -152,6 +153,8 @@ Application::Application(not_null<Launcher*> launcher)
 }
 
 Application::~Application() {
+	StartupTrace::Finish("quit");
+
 	// Depend on activeWindow() for now :(
 	Shortcuts::Finish();
 
@@ -181,7 +184,11 @@ Application::~Application() {
 }
 
 void Application::run() {
-	style::internal::StartFonts();
+	StartupTrace::Mark("Application::run");
+	{
+		const auto phase = StartupTrace::Phase("StartFonts");
+		style::internal::StartFonts();
+	}
 
 	ThirdParty::start();
 	Global::start();
@@ -191,7 +198,10 @@ void Application::run() {
 	// Depends on notifications settings.
 	_notifications = std::make_unique<Window::Notifications::System>();
 
-	startLocalStorage();
+	{
+		const auto phase = StartupTrace::Phase("startLocalStorage");
+		startLocalStorage();
+	}
 	ValidateScale();
 
 	if (Local::oldSettingsVersion() < AppVersion) {
@@ -213,9 +223,15 @@ void Application::run() {
 	_translator = std::make_unique<Lang::Translator>();
 	QCoreApplication::instance()->installTranslator(_translator.get());
 
-	style::startManager(cScale());
+	{
+		const auto phase = StartupTrace::Phase("style::startManager");
+		style::startManager(cScale());
+	}
 	Ui::InitTextOptions();
-	Ui::Emoji::Init();
+	{
+		const auto phase = StartupTrace::Phase("Ui::Emoji::Init");
+		Ui::Emoji::Init();
+	}
 	startEmojiImageLoader();
 	startSystemDarkModeViewer();
 	Media::Player::start(_audio.get());
@@ -238,7 +254,10 @@ void Application::run() {
 	// Create mime database, so it won't be slow later.
 	QMimeDatabase().mimeTypeForName(qsl("text/plain"));
 
-	_window = std::make_unique<Window::Controller>();
+	{
+		const auto phase = StartupTrace::Phase("Window::Controller");
+		_window = std::make_unique<Window::Controller>();
+	}
 
 	_domain->activeChanges(
 	) | rpl::start_with_next([=](not_null<Main::Account*> account) {
@@ -261,9 +280,15 @@ void Application::run() {
 	// Depend on activeWindow() for now :(
 	startShortcuts();
 	App::initMedia();
-	startDomain();
+	{
+		const auto phase = StartupTrace::Phase("startDomain");
+		startDomain();
+	}
 
-	_window->widget()->show();
+	{
+		const auto phase = StartupTrace::Phase("window show");
+		_window->widget()->show();
+	}
 
 	const auto currentGeometry = _window->widget()->geometry();
 	_mediaView = std::make_unique<Media::View::OverlayWidget>();
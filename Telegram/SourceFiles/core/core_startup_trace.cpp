@@ -0,0 +1,110 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/core_startup_trace.h"
+
+#include "settings.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QElapsedTimer>
+
+namespace Core::StartupTrace {
+namespace {
+
+struct Event {
+	const char *name = nullptr;
+	int64 start = 0;
+	int64 duration = -1; // Instant event.
+};
+
+struct State {
+	QElapsedTimer timer;
+	std::vector<Event> events;
+	bool finished = false;
+};
+
+std::unique_ptr<State> Instance;
+
+[[nodiscard]] int64 NowMicroseconds() {
+	return Instance->timer.nsecsElapsed() / 1000;
+}
+
+void Write(const QString &path) {
+	auto events = QJsonArray();
+	for (const auto &event : Instance->events) {
+		auto object = QJsonObject();
+		object.insert("name", QString::fromLatin1(event.name));
+		object.insert("cat", "startup");
+		object.insert("ph", (event.duration < 0) ? "i" : "X");
+		object.insert("ts", double(event.start));
+		if (event.duration >= 0) {
+			object.insert("dur", double(event.duration));
+		} else {
+			object.insert("s", "g");
+		}
+		object.insert("pid", 1);
+		object.insert("tid", 1);
+		events.push_back(object);
+	}
+	auto root = QJsonObject();
+	root.insert("traceEvents", events);
+
+	auto f = QFile(path);
+	if (f.open(QIODevice::WriteOnly)) {
+		f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+		LOG(("Startup Trace: written to '%1'.").arg(path));
+	} else {
+		LOG(("Startup Trace Error: could not write '%1'.").arg(path));
+	}
+}
+
+} // namespace
+
+void Enable() {
+	Expects(!Instance);
+
+	Instance = std::make_unique<State>();
+	Instance->timer.start();
+}
+
+bool Enabled() {
+	return Instance && !Instance->finished;
+}
+
+void Mark(const char *name) {
+	if (Enabled()) {
+		Instance->events.push_back({ name, NowMicroseconds() });
+	}
+}
+
+void Finish(const char *reason) {
+	if (!Enabled()) {
+		return;
+	}
+	Mark(reason);
+	Instance->finished = true;
+	Write(cWorkingDir() + qsl("tdata/startup_trace.json"));
+	Instance->events = std::vector<Event>();
+}
+
+Phase::Phase(const char *name)
+: _name(Enabled() ? name : nullptr)
+, _started(_name ? NowMicroseconds() : 0) {
+}
+
+Phase::~Phase() {
+	if (_name && Enabled()) {
+		Instance->events.push_back({
+			_name,
+			_started,
+			NowMicroseconds() - _started });
+	}
+}
+
+} // namespace Core::StartupTrace
@@ -0,0 +1,33 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Core::StartupTrace {
+
+// Enabled by the -tracestartup command line switch.
+// Writes a Chrome trace (chrome://tracing) JSON to the working dir.
+void Enable();
+[[nodiscard]] bool Enabled();
+
+void Mark(const char *name);
+void Finish(const char *reason);
+
+class Phase final {
+public:
+	explicit Phase(const char *name);
+	Phase(const Phase &other) = delete;
+	Phase &operator=(const Phase &other) = delete;
+	~Phase();
+
+private:
+	const char *_name = nullptr;
+	int64 _started = 0;
+
+};
+
+} // namespace Core::StartupTrace
@@ -14,6 +14,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/main_queue_processor.h"
 #include "ui/ui_utility.h"
 #include "core/crash_reports.h"
+#include "core/core_startup_trace.h"
 #include "core/update_checker.h"
 #include "core/sandbox.h"
 #include "base/concurrent_timer.h"
@@ -454,6 +455,8 @@ void Launcher::processArguments() {
 		{ "-workdir"        , KeyFormat::OneValue },
 		{ "--"              , KeyFormat::OneValue },
 		{ "-scale"          , KeyFormat::OneValue },
+		{ "-pixmapcache"    , KeyFormat::OneValue },
+		{ "-tracestartup"   , KeyFormat::NoValues },
 	};
 	auto parseResult = QMap<QByteArray, QStringList>();
 	auto parsingKey = QByteArray();
@@ -493,6 +496,9 @@ void Launcher::processArguments() {
 	gNoStartUpdate = parseResult.contains("-noupdate");
 	gStartToSettings = parseResult.contains("-tosettings");
 	gStartInTray = parseResult.contains("-startintray");
+	if (parseResult.contains("-tracestartup")) {
+		StartupTrace::Enable();
+	}
 	gSendPaths = parseResult.value("-sendpath", {});
 	gWorkingDir = parseResult.value("-workdir", {}).join(QString());
 	if (!gWorkingDir.isEmpty()) {
@@ -511,6 +517,14 @@ void Launcher::processArguments() {
 			? style::kScaleAuto
 			: value;
 	}
+
+	const auto pixmapCacheKey = parseResult.value("-pixmapcache", {});
+	if (pixmapCacheKey.size() > 0) {
+		const auto value = pixmapCacheKey[0].toInt();
+		if (value >= 32 && value <= 4096) {
+			gPixmapCacheMegabytes = value;
+		}
+	}
 }
 
 int Launcher::executeApplication() {
@@ -23,7 +23,8 @@ void Changes::Manager<DataType, UpdateType>::updated(
 			flags |= i->second;
 			_updates.erase(i);
 		}
-		_stream.fire({ data, flags });
+		fire(data, flags);
+		_dataStreams.remove(data);
 	} else {
 		_updates[data] |= flags;
 	}
@@ -50,14 +51,51 @@ rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 	});
 }
 
+template <typename DataType, typename UpdateType>
+void Changes::Manager<DataType, UpdateType>::fire(
+		not_null<DataType*> data,
+		Flags flags) {
+	_stream.fire({ data, flags });
+
+	const auto i = _dataStreams.find(data);
+	if (i == _dataStreams.end()) {
+		return;
+	} else if (!i->second->consumers) {
+		_dataStreams.erase(i);
+		return;
+	}
+	// Consumers may subscribe or unsubscribe while we fire.
+	const auto stream = i->second;
+	stream->stream.fire({ data, flags });
+}
+
 template <typename DataType, typename UpdateType>
 rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::updates(
 		not_null<DataType*> data,
 		Flags flags) const {
-	return _stream.events(
-	) | rpl::filter([=](const UpdateType &update) {
-		const auto [updateData, updateFlags] = update;
-		return (updateData == data) && (updateFlags & flags);
+	return rpl::make_producer<UpdateType>([=](auto consumer) {
+		auto &stream = _dataStreams[data];
+		if (!stream) {
+			stream = std::make_shared<DataStream>();
+		}
+		++stream->consumers;
+
+		auto result = rpl::lifetime();
+		stream->stream.events(
+		) | rpl::filter([=](const UpdateType &update) {
+			return (update.flags & flags);
+		}) | rpl::start_with_next_done([=](const UpdateType &update) {
+			consumer.put_next_copy(update);
+		}, [=] {
+			consumer.put_done();
+		}, result);
+
+		result.add([weak = std::weak_ptr<DataStream>(stream)] {
+			if (const auto strong = weak.lock()) {
+				--strong->consumers;
+			}
+		});
+		return result;
 	});
 }
 
@@ -79,7 +117,7 @@ rpl::producer<UpdateType> Changes::Manager<DataType, UpdateType>::flagsValue(
 template <typename DataType, typename UpdateType>
 void Changes::Manager<DataType, UpdateType>::sendNotifications() {
 	for (const auto [data, flags] : base::take(_updates)) {
-		_stream.fire({ data, flags });
+		fire(data, flags);
 	}
 }
 
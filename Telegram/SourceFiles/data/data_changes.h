@@ -261,11 +261,22 @@ private:
 	private:
 		static constexpr auto kCount = details::CountBit<Flag>();
 
+		// Updates of a single object, so that they don't wake up
+		// subscribers of all other objects of the same type.
+		struct DataStream {
+			rpl::event_stream<UpdateType> stream;
+			int consumers = 0;
+		};
+
 		void sendRealtimeNotifications(not_null<DataType*> data, Flags flags);
+		void fire(not_null<DataType*> data, Flags flags);
 
 		std::array<rpl::event_stream<UpdateType>, kCount> _realtimeStreams;
 		base::flat_map<not_null<DataType*>, Flags> _updates;
 		rpl::event_stream<UpdateType> _stream;
+		mutable base::flat_map<
+			not_null<DataType*>,
+			std::shared_ptr<DataStream>> _dataStreams;
 
 	};
 
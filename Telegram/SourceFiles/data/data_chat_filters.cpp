@@ -27,6 +27,51 @@ constexpr auto kRefreshSuggestedTimeout = 7200 * crl::time(1000);
 constexpr auto kLoadExceptionsAfter = 100;
 constexpr auto kLoadExceptionsPerRequest = 100;
 
+using Flag = ChatFilter::Flag;
+constexpr auto kTypeFlags = Flag::Contacts
+	| Flag::NonContacts
+	| Flag::Groups
+	| Flag::Channels
+	| Flag::Bots;
+constexpr auto kExcludeFlags = Flag::NoMuted
+	| Flag::NoRead
+	| Flag::NoArchived;
+
+[[nodiscard]] bool IsSubset(
+		const base::flat_set<not_null<History*>> &a,
+		const base::flat_set<not_null<History*>> &b) {
+	return std::includes(begin(b), end(b), begin(a), end(a));
+}
+
+// Whether every chat matching 'now' matched 'was' as well.
+[[nodiscard]] bool OnlyNarrowed(const ChatFilter &was, const ChatFilter &now) {
+	const auto wasTypes = (was.flags() & kTypeFlags);
+	const auto nowTypes = (now.flags() & kTypeFlags);
+	const auto wasExcluded = (was.flags() & kExcludeFlags);
+	const auto nowExcluded = (now.flags() & kExcludeFlags);
+	return ((nowTypes & wasTypes) == nowTypes)
+		&& (!nowTypes || ((nowExcluded & wasExcluded) == wasExcluded))
+		&& IsSubset(now.always(), was.always())
+		&& IsSubset(was.never(), now.never());
+}
+
+[[nodiscard]] base::flat_set<not_null<History*>> ChangedExceptions(
+		const ChatFilter &was,
+		const ChatFilter &now) {
+	auto result = std::vector<not_null<History*>>();
+	const auto add = [&](const auto &a, const auto &b) {
+		std::set_symmetric_difference(
+			begin(a),
+			end(a),
+			begin(b),
+			end(b),
+			std::back_inserter(result));
+	};
+	add(was.always(), now.always());
+	add(was.never(), now.never());
+	return { begin(result), end(result) };
+}
+
 } // namespace
 
 ChatFilter::ChatFilter(
@@ -367,10 +412,14 @@ bool ChatFilters::applyChange(ChatFilter &filter, ChatFilter &&updated) {
 		return false;
 	}
 	if (rulesChanged) {
+		const auto batch = Dialogs::UnreadStateChangesBatch();
 		const auto filterList = _owner->chatsFilters().chatsList(id);
 		const auto feedHistory = [&](not_null<History*> history) {
+			if (!history->inChatList()) {
+				return;
+			}
 			const auto now = updated.contains(history);
-			const auto was = filter.contains(history);
+			const auto was = history->inChatList(id);
 			if (now != was) {
 				if (now) {
 					history->addToChatList(id, filterList);
@@ -380,15 +429,31 @@ bool ChatFilters::applyChange(ChatFilter &filter, ChatFilter &&updated) {
 			}
 		};
 		const auto feedList = [&](not_null<const Dialogs::MainList*> list) {
+			auto histories = std::vector<not_null<History*>>();
+			histories.reserve(list->indexed()->size());
 			for (const auto &entry : *list->indexed()) {
 				if (const auto history = entry->history()) {
-					feedHistory(history);
+					histories.push_back(history);
 				}
 			}
+			for (const auto history : histories) {
+				feedHistory(history);
+			}
 		};
-		feedList(_owner->chatsList());
-		if (const auto folder = _owner->folderLoaded(Data::Folder::kId)) {
-			feedList(folder->chatsList());
+
+		// Only the chats that could change their membership are checked,
+		// so that editing a filter doesn't go through all the chats.
+		if (filter.flags() == updated.flags()) {
+			for (const auto history : ChangedExceptions(filter, updated)) {
+				feedHistory(history);
+			}
+		} else if (OnlyNarrowed(filter, updated)) {
+			feedList(filterList);
+		} else {
+			feedList(_owner->chatsList());
+			if (const auto folder = _owner->folderLoaded(Data::Folder::kId)) {
+				feedList(folder->chatsList());
+			}
 		}
 		if (exceptionsChanged && !updated.always().empty()) {
 			_exceptionsToLoad.push_back(id);
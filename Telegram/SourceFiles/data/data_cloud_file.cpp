@@ -212,7 +212,8 @@ void LoadCloudFile(
 		Fn<void(CloudFile&)> done,
 		Fn<void(bool)> fail,
 		Fn<void()> progress,
-		int downloadFrontPartSize = 0) {
+		int downloadFrontPartSize = 0,
+		bool decodeImage = false) {
 	const auto loadSize = downloadFrontPartSize
 		? std::min(downloadFrontPartSize, file.byteSize)
 		: file.byteSize;
@@ -220,8 +221,13 @@ void LoadCloudFile(
 		if (fromCloud == LoadFromCloudOrLocal) {
 			file.loader->permitLoadFromCloud();
 		}
+		if (decodeImage) {
+			file.loader->decodeImageWhenFinished();
+		}
 		if (file.loader->loadSize() < loadSize) {
 			file.loader->increaseLoadSize(loadSize, autoLoading);
+		} else if (!autoLoading) {
+			file.loader->resetAutoLoading();
 		}
 		return;
 	} else if ((file.flags & CloudFile::Flag::Failed)
@@ -242,6 +248,9 @@ void LoadCloudFile(
 		fromCloud,
 		autoLoading,
 		cacheTag);
+	if (decodeImage) {
+		file.loader->decodeImageWhenFinished();
+	}
 
 	const auto finish = [done](CloudFile &file) {
 		if (!file.loader || file.loader->cancelled()) {
@@ -309,7 +318,8 @@ void LoadCloudFile(
 		callback,
 		std::move(fail),
 		std::move(progress),
-		downloadFrontPartSize);
+		downloadFrontPartSize,
+		true);
 }
 
 void LoadCloudFile(
@@ -980,6 +980,9 @@ void DocumentData::save(
 		if (fromCloud == LoadFromCloudOrLocal) {
 			_loader->permitLoadFromCloud();
 		}
+		if (!autoLoading) {
+			_loader->resetAutoLoading();
+		}
 	} else {
 		status = FileReady;
 		auto reader = owner().streaming().sharedReader(this, origin, true);
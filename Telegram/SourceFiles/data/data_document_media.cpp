@@ -70,12 +70,24 @@ enum class FileType {
 		|| (size.width() * size.height() > kReadAreaLimit)) {
 		return QImage();
 	}
+	const auto scaled = size.isValid()
+		&& (size.width() > kWallPaperThumbnailLimit
+			|| size.height() > kWallPaperThumbnailLimit);
+	if (scaled) {
+		// For JPEG this lets libjpeg downscale in the DCT domain,
+		// instead of decoding the full resolution image first.
+		reader.setScaledSize(size.scaled(
+			kWallPaperThumbnailLimit,
+			kWallPaperThumbnailLimit,
+			Qt::KeepAspectRatio));
+	}
 	auto result = reader.read();
 	if (!result.width() || !result.height()) {
 		return QImage();
 	}
-	return (result.width() > kWallPaperThumbnailLimit
-		|| result.height() > kWallPaperThumbnailLimit)
+	return (!scaled
+		&& (result.width() > kWallPaperThumbnailLimit
+			|| result.height() > kWallPaperThumbnailLimit))
 		? result.scaled(
 			kWallPaperThumbnailLimit,
 			kWallPaperThumbnailLimit,
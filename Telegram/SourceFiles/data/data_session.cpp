@@ -2142,6 +2142,7 @@ void Session::unmuteByFinishedDelayed(crl::time delay) {
 }
 
 void Session::unmuteByFinished() {
+	const auto batch = Dialogs::UnreadStateChangesBatch();
 	auto changesInMin = crl::time(0);
 	for (auto i = begin(_mutedPeers); i != end(_mutedPeers);) {
 		const auto history = historyLoaded((*i)->id);
@@ -3753,6 +3754,9 @@ void Session::requestNotifySettings(not_null<PeerData*> peer) {
 void Session::applyNotifySetting(
 		const MTPNotifyPeer &notifyPeer,
 		const MTPPeerNotifySettings &settings) {
+	const auto started = crl::now();
+	const auto batch = Dialogs::UnreadStateChangesBatch();
+	auto defaultsApplied = 0;
 	switch (notifyPeer.type()) {
 	case mtpc_notifyUsers: {
 		if (_defaultUserNotifySettings.change(settings)) {
@@ -3765,6 +3769,7 @@ void Session::applyNotifySetting(
 						|| (!user->notifySilentPosts()
 							&& _defaultUserNotifySettings.silentPosts()))) {
 					updateNotifySettingsLocal(user);
+					++defaultsApplied;
 				}
 			});
 		}
@@ -3780,6 +3785,7 @@ void Session::applyNotifySetting(
 						|| (!peer->notifySilentPosts()
 							&& _defaultChatNotifySettings.silentPosts()))) {
 					updateNotifySettingsLocal(peer);
+					++defaultsApplied;
 				}
 			});
 		}
@@ -3795,6 +3801,7 @@ void Session::applyNotifySetting(
 						|| (!channel->notifySilentPosts()
 							&& _defaultBroadcastNotifySettings.silentPosts()))) {
 					updateNotifySettingsLocal(channel);
+					++defaultsApplied;
 				}
 			});
 		}
@@ -3808,6 +3815,11 @@ void Session::applyNotifySetting(
 		}
 	} break;
 	}
+	if (defaultsApplied) {
+		DEBUG_LOG(("Notify Settings: defaults applied to %1 chats in %2 ms."
+			).arg(defaultsApplied
+			).arg(crl::now() - started));
+	}
 }
 
 void Session::updateNotifySettings(
@@ -273,6 +273,7 @@ void Entry::addChatListEntryByLetter(
 }
 
 void Entry::updateChatListEntry() {
+	invalidateChatListPaint();
 	session().changes().entryUpdated(this, Data::EntryUpdate::Flag::Repaint);
 }
 
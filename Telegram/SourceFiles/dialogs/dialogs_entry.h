@@ -126,6 +126,14 @@ public:
 		QChar letter,
 		not_null<Row*> row);
 	void updateChatListEntry();
+
+	// Changes each time something shown in the chat list row changes.
+	[[nodiscard]] int chatListPaintVersion() const {
+		return _chatListPaintVersion;
+	}
+	void invalidateChatListPaint() {
+		++_chatListPaintVersion;
+	}
 	[[nodiscard]] bool isPinnedDialog(FilterId filterId) const {
 		return lookupPinnedIndex(filterId) != 0;
 	}
@@ -220,6 +228,7 @@ private:
 	uint64 _sortKeyByDate = 0;
 	base::flat_map<FilterId, int> _pinnedIndex;
 	TimeId _timeId = 0;
+	int _chatListPaintVersion = 0;
 	bool _isTopPromoted = false;
 	const bool _isFolder = false;
 
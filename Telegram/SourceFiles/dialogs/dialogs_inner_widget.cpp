@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history_item.h"
 #include "core/shortcuts.h"
 #include "core/application.h"
+#include "core/core_startup_trace.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/popup_menu.h"
 #include "ui/text/text_utilities.h"
@@ -59,6 +60,7 @@ namespace {
 
 constexpr auto kHashtagResultsLimit = 5;
 constexpr auto kStartReorderThreshold = 30;
+constexpr auto kPaintStatsLogPeriod = 10 * crl::time(1000);
 
 int FixedOnTopDialogsCount(not_null<Dialogs::IndexedList*> list) {
 	auto result = 0;
@@ -195,6 +197,7 @@ InnerWidget::InnerWidget(
 	}, lifetime());
 
 	setupOnlineStatusCheck();
+	setupRowFramesInvalidation();
 
 	rpl::merge(
 		session().data().chatsListChanges(),
@@ -220,6 +223,7 @@ InnerWidget::InnerWidget(
 	subscribe(Window::Theme::Background(), [=](const Window::Theme::BackgroundUpdate &data) {
 		if (data.paletteChanged()) {
 			Layout::clearUnreadBadgesCache();
+			Layout::clearRowFramesCache();
 		}
 	});
 
@@ -411,6 +415,17 @@ void InnerWidget::changeOpenedFolder(Data::Folder *folder) {
 }
 
 void InnerWidget::paintEvent(QPaintEvent *e) {
+	const auto traceFinish = gsl::finally([
+			tracing = Core::StartupTrace::Enabled()] {
+		if (tracing) {
+			Core::StartupTrace::Finish("first chats list painted");
+		}
+	});
+	const auto tracePhase = Core::StartupTrace::Phase("chats list paint");
+	const auto paintStarted = crl::profile();
+	const auto paintCounter = gsl::finally([&] {
+		countPaint(crl::profile() - paintStarted);
+	});
 	Painter p(this);
 
 	const auto r = e->rect();
@@ -2974,6 +2989,74 @@ void InnerWidget::setupOnlineStatusCheck() {
 	}, lifetime());
 }
 
+void InnerWidget::setupRowFramesInvalidation() {
+	const auto invalidate = [=](not_null<History*> history) {
+		const auto shown = history->migrateToOrMe();
+		shown->invalidateChatListPaint();
+		repaintDialogRow({ shown, FullMsgId() });
+	};
+
+	using HistoryFlag = Data::HistoryUpdate::Flag;
+	session().changes().historyUpdates(
+		HistoryFlag::UnreadView
+		| HistoryFlag::TopPromoted
+		| HistoryFlag::UnreadMentions
+		| HistoryFlag::LocalMessages
+		| HistoryFlag::ChatOccupied
+		| HistoryFlag::CloudDraft
+	) | rpl::start_with_next([=](const Data::HistoryUpdate &update) {
+		invalidate(update.history);
+	}, lifetime());
+
+	using PeerFlag = Data::PeerUpdate::Flag;
+	session().changes().peerUpdates(
+		PeerFlag::Notifications
+		| PeerFlag::Migration
+		| PeerFlag::OnlineStatus
+		| PeerFlag::GroupCall
+	) | rpl::start_with_next([=](const Data::PeerUpdate &update) {
+		if (const auto history = session().data().historyLoaded(
+				update.peer)) {
+			invalidate(history);
+		}
+	}, lifetime());
+
+	session().changes().messageUpdates(
+		Data::MessageUpdate::Flag::Edited
+		| Data::MessageUpdate::Flag::DialogRowRepaint
+		| Data::MessageUpdate::Flag::DialogRowRefresh
+	) | rpl::start_with_next([=](const Data::MessageUpdate &update) {
+		invalidate(update.item->history());
+	}, lifetime());
+}
+
+void InnerWidget::countPaint(crl::profile_time duration) {
+	const auto now = crl::now();
+	if (!_paintStatsStart) {
+		_paintStatsStart = now;
+	}
+	++_paintStatsCount;
+	_paintStatsTotal += duration;
+	accumulate_max(_paintStatsMax, duration);
+
+	const auto elapsed = now - _paintStatsStart;
+	if (elapsed < kPaintStatsLogPeriod) {
+		return;
+	}
+	const auto frames = Layout::TakeRowFramesStats();
+	DEBUG_LOG(("Dialogs Paint: %1 paints in %2 ms, %3 mcs avg, %4 mcs max, "
+		"rows reused %5, rows rendered %6"
+		).arg(_paintStatsCount
+		).arg(elapsed
+		).arg(_paintStatsTotal / _paintStatsCount
+		).arg(_paintStatsMax
+		).arg(frames.reused
+		).arg(frames.rendered));
+	_paintStatsStart = now;
+	_paintStatsTotal = _paintStatsMax = 0;
+	_paintStatsCount = 0;
+}
+
 void InnerWidget::updateDialogRowCornerStatus(not_null<History*> history) {
 	const auto user = history->peer->isUser();
 	const auto size = user
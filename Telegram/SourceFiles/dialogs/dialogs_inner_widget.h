@@ -223,6 +223,8 @@ private:
 
 	int defaultRowTop(not_null<Row*> row) const;
 	void setupOnlineStatusCheck();
+	void setupRowFramesInvalidation();
+	void countPaint(crl::profile_time duration);
 	void userOnlineUpdated(not_null<PeerData*> peer);
 	void groupHasCallUpdated(not_null<PeerData*> peer);
 
@@ -415,6 +417,11 @@ private:
 
 	base::unique_qptr<Ui::PopupMenu> _menu;
 
+	crl::time _paintStatsStart = 0;
+	crl::profile_time _paintStatsTotal = 0;
+	crl::profile_time _paintStatsMax = 0;
+	int _paintStatsCount = 0;
+
 };
 
 } // namespace Dialogs
@@ -39,6 +39,10 @@ namespace {
 constexpr int kRecentlyInSeconds = 20 * 3600;
 const auto kPsaBadgePrefix = "cloud_lng_badge_psa_";
 
+// Incremented when all the cached row frames become invalid.
+int RowFramesGeneration = 0;
+RowFramesStats FramesStats;
+
 [[nodiscard]] bool ShowUserBotIcon(not_null<UserData*> user) {
 	return user->isBot() && !user->isSupport() && !user->isRepliesChat();
 }
@@ -57,25 +61,26 @@ void PaintRowTopRight(Painter &p, const QString &text, QRect &rectForName, bool
 	p.drawText(rectForName.left() + rectForName.width() + st::dialogsDateSkip, rectForName.top() + st::msgNameFont->height - st::msgDateFont->descent, text);
 }
 
-void PaintRowDate(Painter &p, QDateTime date, QRect &rectForName, bool active, bool selected) {
+[[nodiscard]] QString RowDateText(const QDateTime &date) {
 	const auto now = QDateTime::currentDateTime();
 	const auto &lastTime = date;
 	const auto nowDate = now.date();
 	const auto lastDate = lastTime.date();
 
-	const auto dt = [&] {
-		const auto wasSameDay = (lastDate == nowDate);
-		const auto wasRecently = qAbs(lastTime.secsTo(now)) < kRecentlyInSeconds;
-		if (wasSameDay || wasRecently) {
-			return lastTime.toString(cTimeFormat());
-		} else if (lastDate.year() == nowDate.year()
-			&& lastDate.weekNumber() == nowDate.weekNumber()) {
-			return langDayOfWeek(lastDate);
-		} else {
-			return lastDate.toString(qsl("d.MM.yy"));
-		}
-	}();
-	PaintRowTopRight(p, dt, rectForName, active, selected);
+	const auto wasSameDay = (lastDate == nowDate);
+	const auto wasRecently = qAbs(lastTime.secsTo(now)) < kRecentlyInSeconds;
+	if (wasSameDay || wasRecently) {
+		return lastTime.toString(cTimeFormat());
+	} else if (lastDate.year() == nowDate.year()
+		&& lastDate.weekNumber() == nowDate.weekNumber()) {
+		return langDayOfWeek(lastDate);
+	} else {
+		return lastDate.toString(qsl("d.MM.yy"));
+	}
+}
+
+void PaintRowDate(Painter &p, QDateTime date, QRect &rectForName, bool active, bool selected) {
+	PaintRowTopRight(p, RowDateText(date), rectForName, active, selected);
 }
 
 void PaintNarrowCounter(
@@ -723,84 +728,155 @@ void RowPainter::paint(
 		| (allowUserOnline ? Flag::AllowUserOnline : Flag(0))
 		| (peer && peer->isSelf() ? Flag::SavedMessages : Flag(0))
 		| (peer && peer->isRepliesChat() ? Flag::RepliesMessages : Flag(0));
-	const auto paintItemCallback = [&](int nameleft, int namewidth) {
-		const auto texttop = st::dialogsPadding.y()
-			+ st::msgNameFont->height
-			+ st::dialogsSkip;
-		const auto availableWidth = PaintWideCounter(
-			p,
-			texttop,
-			namewidth,
-			fullWidth,
-			displayUnreadCounter,
-			displayUnreadMark,
-			displayMentionBadge,
-			displayPinnedIcon,
-			unreadCount,
-			active,
-			selected,
-			unreadMuted,
-			mentionMuted);
-		const auto &color = active
-			? st::dialogsTextFgServiceActive
-			: (selected
-				? st::dialogsTextFgServiceOver
-				: st::dialogsTextFgService);
-		const auto itemRect = QRect(
-			nameleft,
-			texttop,
-			availableWidth,
-			st::dialogsTextFont->height);
-		const auto actionWasPainted = ShowSendActionInDialogs(history)
-			? history->sendActionPainter()->paint(
-				p,
-				itemRect.x(),
-				itemRect.y(),
-				itemRect.width(),
+
+	const auto cornerBadgeUserpic = from
+		&& history
+		&& (flags & Flag::AllowUserOnline)
+		&& !(flags & (Flag::SavedMessages | Flag::RepliesMessages));
+	if (cornerBadgeUserpic) {
+		row->updateCornerBadgeShown(from);
+	}
+	const auto cacheable = history
+		&& !entry->session().supportMode()
+		&& !row->animating()
+		&& !(ShowSendActionInDialogs(history)
+			&& history->sendActionPainter()->animating())
+		&& !(cornerBadgeUserpic
+			&& row->cornerBadgeShown()
+			&& !history->peer->isUser());
+	const auto frameKey = [&] {
+		auto result = RowFrameKey();
+		result.item = item;
+		result.textCachedFor = entry->textCachedFor;
+		result.draft = cloudDraft;
+		result.userpic = from
+			? from->userpicUniqueKey(row->userpicView())
+			: InMemoryKey();
+		result.date = displayDate.isValid()
+			? RowDateText(displayDate)
+			: QString();
+		result.version = entry->chatListPaintVersion();
+		result.nameVersion = peer ? peer->nameVersion : 0;
+		result.generation = RowFramesGeneration;
+		result.unreadCount = unreadCount;
+		result.width = fullWidth;
+		result.filterId = filterId;
+		result.state = (active ? 0x001U : 0U)
+			| (selected ? 0x002U : 0U)
+			| (displayUnreadCounter ? 0x004U : 0U)
+			| (displayUnreadMark ? 0x008U : 0U)
+			| (displayMentionBadge ? 0x010U : 0U)
+			| (displayPinnedIcon ? 0x020U : 0U)
+			| (unreadMuted ? 0x040U : 0U)
+			| (mentionMuted ? 0x080U : 0U)
+			| (allowUserOnline ? 0x100U : 0U)
+			| (row->cornerBadgeShown() ? 0x200U : 0U);
+		return result;
+	};
+	if (cacheable) {
+		if (const auto frame = row->frame(frameKey())) {
+			p.drawImage(0, 0, *frame);
+			++FramesStats.reused;
+			return;
+		}
+	}
+	const auto paintContent = [&](Painter &q) {
+		const auto paintItemCallback = [&](int nameleft, int namewidth) {
+			const auto texttop = st::dialogsPadding.y()
+				+ st::msgNameFont->height
+				+ st::dialogsSkip;
+			const auto availableWidth = PaintWideCounter(
+				q,
+				texttop,
+				namewidth,
 				fullWidth,
-				color,
-				ms)
-			: false;
-		if (const auto folder = row->folder()) {
-			PaintListEntryText(p, itemRect, active, selected, row);
-		} else if (!actionWasPainted) {
-			item->drawInDialog(
-				p,
-				itemRect,
+				displayUnreadCounter,
+				displayUnreadMark,
+				displayMentionBadge,
+				displayPinnedIcon,
+				unreadCount,
 				active,
 				selected,
-				HistoryItem::DrawInDialog::Normal,
-				entry->textCachedFor,
-				entry->lastItemTextCache);
-		}
-	};
-	const auto paintCounterCallback = [&] {
-		PaintNarrowCounter(
-			p,
-			displayUnreadCounter,
-			displayUnreadMark,
-			displayMentionBadge,
-			unreadCount,
-			active,
-			unreadMuted,
-			mentionMuted);
+				unreadMuted,
+				mentionMuted);
+			const auto &color = active
+				? st::dialogsTextFgServiceActive
+				: (selected
+					? st::dialogsTextFgServiceOver
+					: st::dialogsTextFgService);
+			const auto itemRect = QRect(
+				nameleft,
+				texttop,
+				availableWidth,
+				st::dialogsTextFont->height);
+			const auto actionWasPainted = ShowSendActionInDialogs(history)
+				? history->sendActionPainter()->paint(
+					q,
+					itemRect.x(),
+					itemRect.y(),
+					itemRect.width(),
+					fullWidth,
+					color,
+					ms)
+				: false;
+			if (const auto folder = row->folder()) {
+				PaintListEntryText(q, itemRect, active, selected, row);
+			} else if (!actionWasPainted) {
+				item->drawInDialog(
+					q,
+					itemRect,
+					active,
+					selected,
+					HistoryItem::DrawInDialog::Normal,
+					entry->textCachedFor,
+					entry->lastItemTextCache);
+			}
+		};
+		const auto paintCounterCallback = [&] {
+			PaintNarrowCounter(
+				q,
+				displayUnreadCounter,
+				displayUnreadMark,
+				displayMentionBadge,
+				unreadCount,
+				active,
+				unreadMuted,
+				mentionMuted);
+		};
+		paintRow(
+			q,
+			row,
+			entry,
+			row->key(),
+			filterId,
+			from,
+			nullptr,
+			item,
+			cloudDraft,
+			displayDate,
+			fullWidth,
+			flags,
+			ms,
+			paintItemCallback,
+			paintCounterCallback);
 	};
-	paintRow(
-		p,
-		row,
-		entry,
-		row->key(),
-		filterId,
-		from,
-		nullptr,
-		item,
-		cloudDraft,
-		displayDate,
-		fullWidth,
-		flags,
-		ms,
-		paintItemCallback,
-		paintCounterCallback);
+	if (!cacheable) {
+		paintContent(p);
+		return;
+	}
+	auto frame = QImage(
+		QSize(fullWidth, st::dialogsRowHeight) * cIntRetinaFactor(),
+		QImage::Format_ARGB32_Premultiplied);
+	frame.setDevicePixelRatio(cRetinaFactor());
+	{
+		Painter q(&frame);
+		paintContent(q);
+	}
+	p.drawImage(0, 0, frame);
+	++FramesStats.rendered;
+	if (!row->animating()) {
+		row->storeFrame(frameKey(), std::move(frame));
+	}
 }
 
 void RowPainter::paint(
@@ -989,6 +1065,14 @@ void PaintCollapsedRow(
 	}
 }
 
+void clearRowFramesCache() {
+	++RowFramesGeneration;
+}
+
+RowFramesStats TakeRowFramesStats() {
+	return base::take(FramesStats);
+}
+
 void clearUnreadBadgesCache() {
 	if (unreadBadgeStyle) {
 		for (auto &data : unreadBadgeStyle->sizes) {
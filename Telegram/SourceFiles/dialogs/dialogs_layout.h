@@ -91,6 +91,13 @@ void paintUnreadCount(
 	int allowDigits = 0);
 
 void clearUnreadBadgesCache();
+void clearRowFramesCache();
+
+struct RowFramesStats {
+	int reused = 0;
+	int rendered = 0;
+};
+[[nodiscard]] RowFramesStats TakeRowFramesStats();
 
 } // namespace Layout
 } // namespace Dialogs
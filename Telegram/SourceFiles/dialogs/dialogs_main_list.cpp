@@ -12,6 +12,28 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 
 namespace Dialogs {
+namespace {
+
+int BatchesCount = 0;
+std::vector<not_null<MainList*>> BatchedLists;
+
+} // namespace
+
+UnreadStateChangesBatch::UnreadStateChangesBatch() {
+	++BatchesCount;
+}
+
+UnreadStateChangesBatch::~UnreadStateChangesBatch() {
+	if (--BatchesCount) {
+		return;
+	}
+	while (!BatchedLists.empty()) {
+		const auto list = BatchedLists.front();
+		BatchedLists.erase(begin(BatchedLists));
+		list->_unreadStateChanges.fire_copy(
+			*base::take(list->_batchedWasState));
+	}
+}
 
 MainList::MainList(
 	not_null<Main::Session*> session,
@@ -34,6 +56,14 @@ MainList::MainList(
 	}, _lifetime);
 }
 
+MainList::~MainList() {
+	if (_batchedWasState) {
+		BatchedLists.erase(
+			ranges::remove(BatchedLists, this),
+			end(BatchedLists));
+	}
+}
+
 bool MainList::empty() const {
 	return _all.empty();
 }
@@ -189,6 +219,15 @@ UnreadState MainList::unreadState() const {
 	return result;
 }
 
+void MainList::notifyUnreadStateChanged(const UnreadState &wasState) {
+	if (!BatchesCount) {
+		_unreadStateChanges.fire_copy(wasState);
+	} else if (!_batchedWasState) {
+		_batchedWasState = wasState;
+		BatchedLists.push_back(this);
+	}
+}
+
 rpl::producer<UnreadState> MainList::unreadStateChanges() const {
 	return _unreadStateChanges.events();
 }
@@ -16,12 +16,25 @@ class Session;
 
 namespace Dialogs {
 
+// While a batch exists the lists postpone their unreadStateChanges(),
+// so that a change of many entries is reported once for each list.
+class UnreadStateChangesBatch final {
+public:
+	UnreadStateChangesBatch();
+	UnreadStateChangesBatch(const UnreadStateChangesBatch &other) = delete;
+	UnreadStateChangesBatch &operator=(
+		const UnreadStateChangesBatch &other) = delete;
+	~UnreadStateChangesBatch();
+
+};
+
 class MainList final {
 public:
 	MainList(
 		not_null<Main::Session*> session,
 		FilterId filterId,
 		rpl::producer<int> pinnedLimit);
+	~MainList();
 
 	bool empty() const;
 	bool loaded() const;
@@ -52,6 +65,8 @@ public:
 	[[nodiscard]] const rpl::variable<int> &fullSize() const;
 
 private:
+	friend class UnreadStateChangesBatch;
+
 	void finalizeCloudUnread();
 	void recomputeFullListSize();
 
@@ -59,10 +74,11 @@ private:
 		const auto wasState = notify ? unreadState() : UnreadState();
 		return gsl::finally([=] {
 			if (notify) {
-				_unreadStateChanges.fire_copy(wasState);
+				notifyUnreadStateChanged(wasState);
 			}
 		});
 	}
+	void notifyUnreadStateChanged(const UnreadState &wasState);
 
 	FilterId _filterId = 0;
 	IndexedList _all;
@@ -70,6 +86,7 @@ private:
 	UnreadState _unreadState;
 	UnreadState _cloudUnreadState;
 	rpl::event_stream<UnreadState> _unreadStateChanges;
+	std::optional<UnreadState> _batchedWasState;
 	rpl::variable<int> _fullListSize = 0;
 	int _cloudListSize = 0;
 
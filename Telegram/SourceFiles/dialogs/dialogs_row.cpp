@@ -20,6 +20,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Dialogs {
 namespace {
 
+constexpr auto kMaxRowFrames = 64;
+
+// Rows with a cached frame and the last time that frame was used.
+base::flat_map<not_null<const Row*>, uint64> RowFrames;
+uint64 RowFramesUseCounter = 0;
+
 QString ComposeFolderListEntryText(not_null<Data::Folder*> folder) {
 	const auto &list = folder->lastHistories();
 	if (list.empty()) {
@@ -71,6 +77,12 @@ QString ComposeFolderListEntryText(not_null<Data::Folder*> folder) {
 BasicRow::BasicRow() = default;
 BasicRow::~BasicRow() = default;
 
+bool BasicRow::animating() const {
+	return _ripple
+		|| (_cornerBadgeUserpic
+			&& _cornerBadgeUserpic->animation.animating());
+}
+
 void BasicRow::setCornerBadgeShown(
 		bool shown,
 		Fn<void()> updateCallback) const {
@@ -267,6 +279,10 @@ uint64 Row::sortKey(FilterId filterId) const {
 	return _id.entry()->sortKeyInChatList(filterId);
 }
 
+Row::~Row() {
+	clearFrame();
+}
+
 void Row::validateListEntryCache() const {
 	const auto folder = _id.folder();
 	if (!folder) {
@@ -283,6 +299,49 @@ void Row::validateListEntryCache() const {
 		Ui::DialogTextOptions());
 }
 
+const QImage *Row::frame(const RowFrameKey &key) const {
+	if (_frame.isNull() || !(_frameKey == key)) {
+		return nullptr;
+	}
+	RowFrames[this] = ++RowFramesUseCounter;
+	return &_frame;
+}
+
+void Row::storeFrame(const RowFrameKey &key, QImage frame) const {
+	if (_frame.isNull() && int(RowFrames.size()) >= kMaxRowFrames) {
+		const auto oldest = ranges::min_element(
+			RowFrames,
+			ranges::less(),
+			[](const auto &pair) { return pair.second; });
+		oldest->first->clearFrame();
+	}
+	_frameKey = key;
+	_frame = std::move(frame);
+	RowFrames[this] = ++RowFramesUseCounter;
+}
+
+void Row::clearFrame() const {
+	if (!_frame.isNull()) {
+		_frame = QImage();
+		RowFrames.remove(this);
+	}
+}
+
+bool operator==(const RowFrameKey &a, const RowFrameKey &b) {
+	return (a.item == b.item)
+		&& (a.textCachedFor == b.textCachedFor)
+		&& (a.draft == b.draft)
+		&& (a.userpic == b.userpic)
+		&& (a.version == b.version)
+		&& (a.nameVersion == b.nameVersion)
+		&& (a.generation == b.generation)
+		&& (a.unreadCount == b.unreadCount)
+		&& (a.width == b.width)
+		&& (a.filterId == b.filterId)
+		&& (a.state == b.state)
+		&& (a.date == b.date);
+}
+
 FakeRow::FakeRow(Key searchInChat, not_null<HistoryItem*> item)
 : _searchInChat(searchInChat)
 , _item(item)
@@ -16,6 +16,7 @@ class HistoryItem;
 
 namespace Data {
 class CloudImageView;
+struct Draft;
 } // namespace Data
 
 namespace Ui {
@@ -59,6 +60,12 @@ public:
 		return _userpic;
 	}
 
+	// Whether the ripple or the userpic corner badge can change by itself.
+	[[nodiscard]] bool animating() const;
+	[[nodiscard]] bool cornerBadgeShown() const {
+		return _cornerBadgeShown;
+	}
+
 private:
 	struct CornerBadgeUserpic {
 		InMemoryKey key;
@@ -84,12 +91,31 @@ private:
 
 };
 
+// Everything the cached frame of a chat list row was painted from.
+struct RowFrameKey {
+	const HistoryItem *item = nullptr;
+	const HistoryItem *textCachedFor = nullptr;
+	const Data::Draft *draft = nullptr;
+	InMemoryKey userpic;
+	QString date;
+	int version = 0;
+	int nameVersion = 0;
+	int generation = 0;
+	int unreadCount = 0;
+	int width = 0;
+	FilterId filterId = 0;
+	uint32 state = 0;
+};
+
+[[nodiscard]] bool operator==(const RowFrameKey &a, const RowFrameKey &b);
+
 class List;
 class Row : public BasicRow {
 public:
 	explicit Row(std::nullptr_t) {
 	}
 	Row(Key key, int pos);
+	~Row();
 
 	Key key() const {
 		return _id;
@@ -113,6 +139,11 @@ public:
 		return _listEntryCache;
 	}
 
+	// Only a limited amount of the most recently used frames is kept.
+	[[nodiscard]] const QImage *frame(const RowFrameKey &key) const;
+	void storeFrame(const RowFrameKey &key, QImage frame) const;
+	void clearFrame() const;
+
 	// for any attached data, for example View in contacts list
 	void *attached = nullptr;
 
@@ -123,6 +154,8 @@ private:
 	int _pos = 0;
 	mutable uint32 _listEntryCacheVersion = 0;
 	mutable Ui::Text::String _listEntryCache;
+	mutable RowFrameKey _frameKey;
+	mutable QImage _frame;
 
 };
 
@@ -236,6 +236,11 @@ struct ApiWrap::ChatProcess {
 	std::optional<Data::MessagesSlice> slice;
 	bool lastSlice = false;
 	int fileIndex = 0;
+
+	// Next slice is requested while files of the current one are loaded.
+	std::optional<MTPmessages_Messages> preloaded;
+	bool preloading = false;
+	bool waitingPreloaded = false;
 };
 
 
@@ -1385,21 +1390,71 @@ void ApiWrap::requestMessagesSlice() {
 		-kMessagesSliceLimit,
 		kMessagesSliceLimit,
 		[=](const MTPmessages_Messages &result) {
+		processMessagesSlice(result);
+	});
+}
+
+void ApiWrap::requestNextMessagesSlice() {
+	Expects(_chatProcess != nullptr);
+
+	if (_chatProcess->preloaded) {
+		processMessagesSlice(*base::take(_chatProcess->preloaded));
+	} else if (_chatProcess->preloading) {
+		_chatProcess->waitingPreloaded = true;
+	} else {
+		requestMessagesSlice();
+	}
+}
+
+void ApiWrap::preloadNextMessagesSlice() {
+	Expects(_chatProcess != nullptr);
+	Expects(_chatProcess->slice.has_value());
+	Expects(!_chatProcess->preloading && !_chatProcess->preloaded);
+
+	// Same position as finishMessagesSlice() will move to.
+	auto localSplitIndex = _chatProcess->localSplitIndex;
+	auto offsetId = int32(1);
+	if (!_chatProcess->lastSlice) {
+		offsetId = _chatProcess->slice->list.back().id + 1;
+	} else if (++localSplitIndex >= _chatProcess->info.splits.size()) {
+		return;
+	}
+	if (!_chatProcess->info.messagesCountPerSplit[localSplitIndex]) {
+		return;
+	}
+	_chatProcess->preloading = true;
+	requestChatMessages(
+		_chatProcess->info.splits[localSplitIndex],
+		offsetId,
+		-kMessagesSliceLimit,
+		kMessagesSliceLimit,
+		[=](MTPmessages_Messages &&result) {
 		Expects(_chatProcess != nullptr);
 
-		result.match([&](const MTPDmessages_messagesNotModified &data) {
-			error("Unexpected messagesNotModified received.");
-		}, [&](const auto &data) {
-			if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
-				_chatProcess->lastSlice = true;
-			}
-			loadMessagesFiles(Data::ParseMessagesSlice(
-				_chatProcess->context,
-				data.vmessages(),
-				data.vusers(),
-				data.vchats(),
-				_chatProcess->info.relativePath));
-		});
+		_chatProcess->preloading = false;
+		if (base::take(_chatProcess->waitingPreloaded)) {
+			processMessagesSlice(result);
+		} else {
+			_chatProcess->preloaded = std::move(result);
+		}
+	});
+}
+
+void ApiWrap::processMessagesSlice(const MTPmessages_Messages &result) {
+	Expects(_chatProcess != nullptr);
+
+	result.match([&](const MTPDmessages_messagesNotModified &data) {
+		error("Unexpected messagesNotModified received.");
+	}, [&](const auto &data) {
+		if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
+			_chatProcess->lastSlice = true;
+		}
+		loadMessagesFiles(Data::ParseMessagesSlice(
+			_chatProcess->context,
+			data.vmessages(),
+			data.vusers(),
+			data.vchats(),
+			_chatProcess->info.relativePath));
 	});
 }
 
@@ -1485,6 +1540,7 @@ void ApiWrap::loadMessagesFiles(Data::MessagesSlice &&slice) {
 	_chatProcess->slice = std::move(slice);
 	_chatProcess->fileIndex = 0;
 
+	preloadNextMessagesSlice();
 	loadNextMessageFile();
 }
 
@@ -1574,7 +1630,7 @@ void ApiWrap::finishMessagesSlice() {
 		_chatProcess->largestIdPlusOne = 1;
 	}
 	if (!_chatProcess->lastSlice) {
-		requestMessagesSlice();
+		requestNextMessagesSlice();
 	} else {
 		finishMessages();
 	}
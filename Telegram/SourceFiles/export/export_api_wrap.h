@@ -147,6 +147,9 @@ private:
 	void checkFirstMessageDate(int localSplitIndex, int count);
 	void messagesCountLoaded(int localSplitIndex, int count);
 	void requestMessagesSlice();
+	void requestNextMessagesSlice();
+	void preloadNextMessagesSlice();
+	void processMessagesSlice(const MTPmessages_Messages &result);
 	void requestChatMessages(
 		int splitIndex,
 		int offsetId,
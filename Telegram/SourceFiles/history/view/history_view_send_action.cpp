@@ -137,6 +137,10 @@ bool SendActionPainter::paint(
 	return false;
 }
 
+bool SendActionPainter::animating() const {
+	return !!_sendActionAnimation;
+}
+
 void SendActionPainter::paintSpeaking(
 		Painter &p,
 		int x,
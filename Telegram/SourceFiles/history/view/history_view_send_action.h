@@ -35,6 +35,7 @@ public:
 		int outerWidth,
 		style::color color,
 		crl::time now);
+	[[nodiscard]] bool animating() const;
 	void paintSpeaking(
 		Painter &p,
 		int x,
@@ -50,6 +50,9 @@ constexpr auto kPreloadIfLessThanScreens = 2;
 constexpr auto kPreloadedScreensCountFull
 	= kPreloadedScreensCount + 1 + kPreloadedScreensCount;
 constexpr auto kMediaCountForSearch = 10;
+constexpr auto kPreloadThumbnailsMaxScreens = 4;
+constexpr auto kPreloadThumbnailsBatch = 24;
+constexpr auto kScrollVelocityTimeout = crl::time(300);
 
 UniversalMsgId GetUniversalId(FullMsgId itemId) {
 	return (itemId.channel != 0)
@@ -114,6 +117,10 @@ public:
 	FoundItem findItemNearId(UniversalMsgId universalId) const;
 	FoundItem findItemDetails(not_null<BaseLayout*> item) const;
 	FoundItem findItemByPoint(QPoint point) const;
+	void collectItems(
+		int top,
+		int bottom,
+		std::vector<not_null<BaseLayout*>> &result) const;
 
 	void paint(
 		Painter &p,
@@ -372,6 +379,17 @@ auto ListWidget::Section::findItemAfterBottom(
 		});
 }
 
+void ListWidget::Section::collectItems(
+		int top,
+		int bottom,
+		std::vector<not_null<BaseLayout*>> &result) const {
+	const auto fromIt = findItemAfterTop(top);
+	const auto tillIt = findItemAfterBottom(fromIt, bottom);
+	for (auto it = fromIt; it != tillIt; ++it) {
+		result.push_back(it->second);
+	}
+}
+
 void ListWidget::Section::paint(
 		Painter &p,
 		const Context &context,
@@ -640,6 +658,8 @@ void ListWidget::restart() {
 	_sections.clear();
 	_layouts.clear();
 	_heavyLayouts.clear();
+	_thumbnailsMissingPainted += int(_thumbnailsMissingLayouts.size());
+	_thumbnailsMissingLayouts.clear();
 
 	_universalAroundId = kDefaultAroundId;
 	_idsLimit = kMinimalIdsLimit;
@@ -672,6 +692,7 @@ void ListWidget::itemRemoved(not_null<const HistoryItem*> item) {
 
 	if (const auto i = _layouts.find(id); i != _layouts.end()) {
 		_heavyLayouts.remove(i->second.item.get());
+		forgetPaintedWithoutThumbnail(i->second.item.get());
 		_layouts.erase(i);
 	}
 	_dragSelected.remove(id);
@@ -830,6 +851,19 @@ void ListWidget::unregisterHeavyItem(not_null<const BaseLayout*> item) {
 	}
 }
 
+void ListWidget::paintedWithoutThumbnail(
+		not_null<const BaseLayout*> item) {
+	_thumbnailsMissingLayouts.emplace(item);
+}
+
+void ListWidget::forgetPaintedWithoutThumbnail(
+		not_null<const BaseLayout*> item) {
+	// Layout pointers may be reused, so count the destroyed ones now.
+	if (_thumbnailsMissingLayouts.remove(item)) {
+		++_thumbnailsMissingPainted;
+	}
+}
+
 SparseIdsMergedSlice::Key ListWidget::sliceKey(
 		UniversalMsgId universalId) const {
 	using Key = SparseIdsMergedSlice::Key;
@@ -1069,8 +1103,71 @@ void ListWidget::visibleTopBottomUpdated(
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
+	updateScrollVelocity();
 	checkMoveToOtherViewer();
 	clearHeavyItems();
+	preloadThumbnails();
+}
+
+void ListWidget::updateScrollVelocity() {
+	const auto now = crl::now();
+	const auto delta = _visibleTop - _lastScrollTop;
+	const auto elapsed = now - _lastScrollTime;
+	const auto visibleHeight = _visibleBottom - _visibleTop;
+	_lastScrollTop = _visibleTop;
+	_lastScrollTime = now;
+	if (!delta || visibleHeight <= 0) {
+		return;
+	}
+	_scrollDirection = (delta > 0) ? 1 : -1;
+
+	// Look one more screen ahead for each two screens per second.
+	const auto screensPerSecond = (elapsed > 0
+		&& elapsed < kScrollVelocityTimeout)
+		? (std::abs(delta) * 1000. / (elapsed * visibleHeight))
+		: 0.;
+	_preloadThumbnailsScreens = std::clamp(
+		1 + int(screensPerSecond / 2.),
+		1,
+		kPreloadThumbnailsMaxScreens);
+}
+
+void ListWidget::preloadThumbnails() {
+	const auto visibleHeight = _visibleBottom - _visibleTop;
+	if ((_type != Type::Photo && _type != Type::Video)
+		|| visibleHeight <= 0
+		|| _sections.empty()) {
+		return;
+	}
+	const auto ahead = _preloadThumbnailsScreens * visibleHeight;
+	const auto top = (_scrollDirection > 0)
+		? _visibleTop
+		: (_visibleTop - ahead);
+	const auto bottom = (_scrollDirection > 0)
+		? (_visibleBottom + ahead)
+		: _visibleBottom;
+
+	auto items = std::vector<not_null<BaseLayout*>>();
+	const auto fromSectionIt = findSectionAfterTop(top);
+	const auto tillSectionIt = findSectionAfterBottom(fromSectionIt, bottom);
+	for (auto it = fromSectionIt; it != tillSectionIt; ++it) {
+		it->collectItems(top - it->top(), bottom - it->top(), items);
+	}
+	if (_scrollDirection < 0) {
+		// Items closest to the visible area in the scroll direction first.
+		ranges::reverse(items);
+	}
+	auto batch = 0;
+	for (const auto item : items) {
+		if (_heavyLayouts.contains(item)) {
+			continue;
+		}
+		item->preloadThumbnail();
+		++_thumbnailsPreloaded;
+		if (++batch == kPreloadThumbnailsBatch) {
+			break;
+		}
+	}
 }
 
 void ListWidget::checkMoveToOtherViewer() {
@@ -1137,8 +1234,13 @@ void ListWidget::clearHeavyItems() {
 		return;
 	}
 	_heavyLayoutsInvalidated = false;
-	const auto above = _visibleTop - visibleHeight;
-	const auto below = _visibleBottom + visibleHeight;
+
+	// Keep the preloaded thumbnails in the scroll direction.
+	const auto ahead = _preloadThumbnailsScreens * visibleHeight;
+	const auto above = _visibleTop
+		- ((_scrollDirection < 0) ? ahead : visibleHeight);
+	const auto below = _visibleBottom
+		+ ((_scrollDirection > 0) ? ahead : visibleHeight);
 	for (auto i = _heavyLayouts.begin(); i != _heavyLayouts.end();) {
 		const auto item = const_cast<BaseLayout*>(i->get());
 		const auto rect = findItemDetails(item).geometry;
@@ -2173,6 +2275,7 @@ void ListWidget::clearStaleLayouts() {
 				_overLayout = nullptr;
 			}
 			_heavyLayouts.erase(i->second.item.get());
+			forgetPaintedWithoutThumbnail(i->second.item.get());
 			i = _layouts.erase(i);
 		} else {
 			++i;
@@ -2223,6 +2326,14 @@ ListWidget::~ListWidget() {
 		// We don't want it to be called after ListWidget is destroyed.
 		_contextMenu->setDestroyedCallback(nullptr);
 	}
+	const auto missing = _thumbnailsMissingPainted
+		+ int(_thumbnailsMissingLayouts.size());
+	if (_thumbnailsPreloaded || missing) {
+		DEBUG_LOG(("Media Info: "
+			"%1 thumbnails preloaded, %2 tiles painted without thumbnail."
+			).arg(_thumbnailsPreloaded
+			).arg(missing));
+	}
 }
 
 } // namespace Media
@@ -78,6 +78,7 @@ public:
 
 	void registerHeavyItem(not_null<const BaseLayout*> item) override;
 	void unregisterHeavyItem(not_null<const BaseLayout*> item) override;
+	void paintedWithoutThumbnail(not_null<const BaseLayout*> item) override;
 
 private:
 	struct Context;
@@ -233,6 +234,7 @@ private:
 
 	void markLayoutsStale();
 	void clearStaleLayouts();
+	void forgetPaintedWithoutThumbnail(not_null<const BaseLayout*> item);
 	std::vector<Section>::iterator findSectionByItem(
 		UniversalMsgId universalId);
 	std::vector<Section>::iterator findSectionAfterTop(int top);
@@ -276,6 +278,8 @@ private:
 	void validateTrippleClickStartTime();
 	void checkMoveToOtherViewer();
 	void clearHeavyItems();
+	void updateScrollVelocity();
+	void preloadThumbnails();
 
 	void setActionBoxWeak(QPointer<Ui::RpWidget> box);
 
@@ -298,6 +302,14 @@ private:
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
 	ScrollTopState _scrollTopState;
+
+	int _lastScrollTop = 0;
+	crl::time _lastScrollTime = 0;
+	int _scrollDirection = 1;
+	int _preloadThumbnailsScreens = 1;
+	int _thumbnailsPreloaded = 0;
+	int _thumbnailsMissingPainted = 0;
+	base::flat_set<not_null<const BaseLayout*>> _thumbnailsMissingLayouts;
 	rpl::event_stream<int> _scrollToRequests;
 
 	MouseAction _mouseAction = MouseAction::None;
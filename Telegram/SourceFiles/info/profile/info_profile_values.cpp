@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/application.h"
 #include "core/click_handler_types.h"
 #include "main/main_session.h"
+#include "storage/storage_account.h"
 #include "ui/wrap/slide_wrap.h"
 #include "ui/text/text_utilities.h"
 #include "lang/lang_keys.h"
@@ -345,7 +346,14 @@ rpl::producer<int> SharedMediaCountValue(
 	) | rpl::map([](const SparseIdsMergedSlice &slice) {
 		return slice.fullCount();
 	}) | rpl::filter_optional();
-	return rpl::single(0) | rpl::then(std::move(updated));
+
+	// Show the counts from the last session until the actual ones arrive.
+	auto &local = peer->session().local();
+	const auto hint = local.sharedMediaCountHint(peer->id, type).value_or(0)
+		+ (migrated
+			? local.sharedMediaCountHint(migrated->id, type).value_or(0)
+			: 0);
+	return rpl::single(hint) | rpl::then(std::move(updated));
 }
 
 rpl::producer<int> CommonGroupsCountValue(not_null<UserData*> user) {
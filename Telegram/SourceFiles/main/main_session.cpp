@@ -137,6 +137,7 @@ Session::Session(
 
 		// Storage::Account uses Main::Account::session() in those methods.
 		// So they can't be called during Main::Session construction.
+		local().prefetchStickersAndGifs();
 		local().readInstalledStickers();
 		local().readFeaturedStickers();
 		local().readRecentStickers();
@@ -1733,9 +1733,17 @@ public:
 
 		auto fmt = format();
 		auto peak = uint16(0);
-		auto callback = [&](uint16 sample) {
-			accumulate_max(peak, sample);
-			sumbytes += Media::Player::kWaveformSamplesCount;
+
+		// Each sample adds kWaveformSamplesCount to sumbytes and a peak is
+		// finished when sumbytes reaches countbytes, so we can reduce the
+		// whole range of samples up to the next peak boundary at once.
+		constexpr auto kStep = int64(Media::Player::kWaveformSamplesCount);
+		const auto limit = [&] {
+			return (countbytes - sumbytes + kStep - 1) / kStep;
+		};
+		const auto callback = [&](int64 count, uint16 rangePeak) {
+			accumulate_max(peak, rangePeak);
+			sumbytes += count * kStep;
 			if (sumbytes >= countbytes) {
 				sumbytes -= countbytes;
 				peaks.push_back(peak);
@@ -1756,9 +1764,15 @@ public:
 
 			auto sampleBytes = bytes::make_span(buffer);
 			if (fmt == AL_FORMAT_MONO8 || fmt == AL_FORMAT_STEREO8) {
-				Media::Audio::IterateSamples<uchar>(sampleBytes, callback);
+				Media::Audio::IterateSamplePeaks<uchar>(
+					sampleBytes,
+					limit,
+					callback);
 			} else if (fmt == AL_FORMAT_MONO16 || fmt == AL_FORMAT_STEREO16) {
-				Media::Audio::IterateSamples<int16>(sampleBytes, callback);
+				Media::Audio::IterateSamplePeaks<int16>(
+					sampleBytes,
+					limit,
+					callback);
 			}
 			processed += sampleSize() * samples;
 		}
@@ -396,21 +396,40 @@ VoiceWaveform audioCountWaveform(const Core::FileLocation &file, const QByteArra
 namespace Media {
 namespace Audio {
 
-TG_FORCE_INLINE uint16 ReadOneSample(uchar data) {
-	return qAbs((static_cast<int16>(data) - 0x80) * 0x100);
+// Branch-free so that the loops are auto-vectorized by the compiler.
+inline uint16 MaxSample(gsl::span<const uchar> samples) {
+	auto result = 0;
+	for (const auto sample : samples) {
+		result = std::max(result, std::abs(int(sample) - 0x80));
+	}
+	return uint16(result * 0x100);
 }
 
-TG_FORCE_INLINE uint16 ReadOneSample(int16 data) {
-	return qAbs(data);
+inline uint16 MaxSample(gsl::span<const int16> samples) {
+	auto result = 0;
+	for (const auto sample : samples) {
+		result = std::max(result, std::abs(int(sample)));
+	}
+	return uint16(result);
 }
 
-template <typename SampleType, typename Callback>
-void IterateSamples(bytes::const_span bytes, Callback &&callback) {
-	auto samplesPointer = reinterpret_cast<const SampleType*>(bytes.data());
-	auto samplesCount = bytes.size() / sizeof(SampleType);
-	auto samplesData = gsl::make_span(samplesPointer, samplesCount);
-	for (auto sampleData : samplesData) {
-		callback(ReadOneSample(sampleData));
+// Calls callback(count, peak) for consecutive ranges of samples, where
+// each range ends either at the end of bytes or after limit() samples.
+template <typename SampleType, typename Limit, typename Callback>
+void IterateSamplePeaks(
+		bytes::const_span bytes,
+		Limit &&limit,
+		Callback &&callback) {
+	auto samples = gsl::make_span(
+		reinterpret_cast<const SampleType*>(bytes.data()),
+		bytes.size() / sizeof(SampleType));
+	while (!samples.empty()) {
+		const auto count = std::min(
+			int64(samples.size()),
+			int64(limit()));
+		Assert(count > 0);
+		callback(count, MaxSample(samples.subspan(0, count)));
+		samples = samples.subspan(count);
 	}
 }
 
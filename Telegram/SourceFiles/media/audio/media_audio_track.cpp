@@ -62,13 +62,17 @@ void Track::fillFromData(bytes::vector &&data) {
 	auto peaksCount = _peakEachPosition ? (loader.samplesCount() / _peakEachPosition) : 0;
 	_peaks.reserve(peaksCount);
 	auto peakValue = uint16(0);
-	auto peakSamples = 0;
+	auto peakSamples = int64(0);
 	auto peakEachSample = (format == AL_FORMAT_STEREO8 || format == AL_FORMAT_STEREO16) ? (_peakEachPosition * 2) : _peakEachPosition;
 	_peakValueMin = 0x7FFF;
 	_peakValueMax = 0;
-	auto peakCallback = [this, &peakValue, &peakSamples, peakEachSample](uint16 sample) {
+	auto peakLimit = [&peakSamples, peakEachSample] {
+		return peakEachSample - peakSamples;
+	};
+	auto peakCallback = [this, &peakValue, &peakSamples, peakEachSample](int64 count, uint16 sample) {
 		accumulate_max(peakValue, sample);
-		if (++peakSamples >= peakEachSample) {
+		peakSamples += count;
+		if (peakSamples >= peakEachSample) {
 			peakSamples -= peakEachSample;
 			_peaks.push_back(peakValue);
 			accumulate_max(_peakValueMax, peakValue);
@@ -86,9 +90,9 @@ void Track::fillFromData(bytes::vector &&data) {
 			_samples.insert(_samples.end(), sampleBytes.data(), sampleBytes.data() + sampleBytes.size());
 			if (peaksCount) {
 				if (format == AL_FORMAT_MONO8 || format == AL_FORMAT_STEREO8) {
-					Media::Audio::IterateSamples<uchar>(sampleBytes, peakCallback);
+					Media::Audio::IterateSamplePeaks<uchar>(sampleBytes, peakLimit, peakCallback);
 				} else if (format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16) {
-					Media::Audio::IterateSamples<int16>(sampleBytes, peakCallback);
+					Media::Audio::IterateSamplePeaks<int16>(sampleBytes, peakLimit, peakCallback);
 				}
 			}
 		}
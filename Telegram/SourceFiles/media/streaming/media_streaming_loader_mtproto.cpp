@@ -18,6 +18,9 @@ namespace {
 
 constexpr auto kMaxConcurrentRequests = 4;
 
+// Parts requested while the file is played should arrive soon.
+constexpr auto kActiveStreamingPartDeadline = crl::time(1000);
+
 } // namespace
 
 LoaderMtproto::LoaderMtproto(
@@ -59,7 +62,9 @@ void LoaderMtproto::load(int offset) {
 }
 
 void LoaderMtproto::addToQueueWithPriority() {
-	addToQueue(_priority);
+	addToQueue(
+		_priority,
+		(_priority > 0) ? (crl::now() + kActiveStreamingPartDeadline) : 0);
 }
 
 void LoaderMtproto::stop() {
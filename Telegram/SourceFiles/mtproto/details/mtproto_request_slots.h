@@ -0,0 +1,133 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace MTP::details {
+
+// Values of in-flight requests, indexed by request id.
+//
+// Request ids are given sequentially, so the ids being in flight at
+// the same time fill neighbour slots of an open addressing table and
+// lookups almost never probe more than one slot. Each slot keeps the
+// full request id, so a stale slot is never mistaken for a live one.
+template <typename Value>
+class RequestSlots final {
+public:
+	[[nodiscard]] Value *find(mtpRequestId requestId) {
+		const auto index = lookup(requestId);
+		return (index >= 0) ? &_slots[index].value : nullptr;
+	}
+	[[nodiscard]] const Value *find(mtpRequestId requestId) const {
+		const auto index = lookup(requestId);
+		return (index >= 0) ? &_slots[index].value : nullptr;
+	}
+	[[nodiscard]] bool contains(mtpRequestId requestId) const {
+		return (lookup(requestId) >= 0);
+	}
+	[[nodiscard]] int size() const {
+		return _count;
+	}
+
+	// Inserts a default value if there was no such request.
+	Value &operator[](mtpRequestId requestId) {
+		Expects(requestId > 0);
+
+		if (const auto index = lookup(requestId); index >= 0) {
+			return _slots[index].value;
+		}
+		if (2 * (_count + 1) > int(_slots.size())) {
+			grow();
+		}
+		++_count;
+		auto &slot = _slots[freeSlot(requestId)];
+		slot.requestId = requestId;
+		return slot.value;
+	}
+
+	void set(mtpRequestId requestId, Value value) {
+		(*this)[requestId] = std::move(value);
+	}
+
+	bool erase(mtpRequestId requestId) {
+		auto index = lookup(requestId);
+		if (index < 0) {
+			return false;
+		}
+		--_count;
+
+		// Shift back the following entries of the probe sequence,
+		// so that lookups can stop at the first empty slot.
+		const auto mask = int(_slots.size()) - 1;
+		for (auto next = (index + 1) & mask
+			; _slots[next].requestId
+			; next = (next + 1) & mask) {
+			const auto home = homeSlot(_slots[next].requestId);
+			const auto stays = (index <= next)
+				? (index < home && home <= next)
+				: (index < home || home <= next);
+			if (!stays) {
+				_slots[index] = std::move(_slots[next]);
+				index = next;
+			}
+		}
+		_slots[index] = Slot();
+		return true;
+	}
+
+private:
+	static constexpr auto kMinimalSize = 64;
+
+	struct Slot {
+		mtpRequestId requestId = 0;
+		Value value = Value();
+	};
+
+	[[nodiscard]] int homeSlot(mtpRequestId requestId) const {
+		return int(uint32(requestId) & uint32(_slots.size() - 1));
+	}
+
+	[[nodiscard]] int lookup(mtpRequestId requestId) const {
+		if (!requestId || _slots.empty()) {
+			return -1;
+		}
+		const auto mask = int(_slots.size()) - 1;
+		for (auto index = homeSlot(requestId)
+			; _slots[index].requestId
+			; index = (index + 1) & mask) {
+			if (_slots[index].requestId == requestId) {
+				return index;
+			}
+		}
+		return -1;
+	}
+
+	[[nodiscard]] int freeSlot(mtpRequestId requestId) const {
+		const auto mask = int(_slots.size()) - 1;
+		auto index = homeSlot(requestId);
+		while (_slots[index].requestId) {
+			index = (index + 1) & mask;
+		}
+		return index;
+	}
+
+	void grow() {
+		auto was = base::take(_slots);
+		_slots.resize(std::max(int(was.size()) * 2, kMinimalSize));
+		for (auto &slot : was) {
+			if (slot.requestId) {
+				_slots[freeSlot(slot.requestId)] = std::move(slot);
+			}
+		}
+	}
+
+	std::vector<Slot> _slots;
+	int _count = 0;
+
+};
+
+} // namespace MTP::details
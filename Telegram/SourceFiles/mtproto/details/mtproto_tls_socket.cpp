@@ -31,6 +31,7 @@ const auto kServerHeader = qstr("\x17\x03\x03");
 constexpr auto kClientPartSize = 2878;
 const auto kClientPrefix = qstr("\x14\x03\x03\x00\x01\x01");
 const auto kClientHeader = qstr("\x17\x03\x03");
+constexpr auto kIncomingCompactThreshold = 64 * 1024;
 
 using BigNum = openssl::BigNum;
 using BigNumContext = openssl::Context;
@@ -509,6 +510,7 @@ void TlsSocket::plainConnected() {
 void TlsSocket::plainDisconnected() {
 	_state = State::NotConnected;
 	_incoming = QByteArray();
+	_incomingStart = 0;
 	_serverHelloLength = 0;
 	_incomingGoodDataOffset = 0;
 	_incomingGoodDataLimit = 0;
@@ -607,7 +609,7 @@ void TlsSocket::checkHelloDigest() {
 		return;
 	}
 	shiftIncomingBy(fulldata.size());
-	if (!_incoming.isEmpty()) {
+	if (incomingSize() > 0) {
 		InvokeQueued(this, [=] {
 			if (!checkNextPacket()) {
 				handleError();
@@ -623,6 +625,7 @@ void TlsSocket::readData() {
 	if (!isConnected()) {
 		return;
 	}
+	compactIncoming();
 	_incoming.append(_socket.readAll());
 	if (!checkNextPacket()) {
 		handleError();
@@ -633,7 +636,7 @@ void TlsSocket::readData() {
 
 bool TlsSocket::checkNextPacket() {
 	auto offset = 0;
-	const auto incoming = bytes::make_span(_incoming);
+	const auto incoming = bytes::make_span(_incoming).subspan(_incomingStart);
 	while (!_incomingGoodDataLimit) {
 		const auto fullHeader = kServerHeader.size() + kLengthSize;
 		if (incoming.size() <= offset + fullHeader) {
@@ -659,19 +662,36 @@ bool TlsSocket::checkNextPacket() {
 	return true;
 }
 
+int TlsSocket::incomingSize() const {
+	return _incoming.size() - _incomingStart;
+}
+
 void TlsSocket::shiftIncomingBy(int amount) {
 	Expects(_incomingGoodDataOffset == 0);
 	Expects(_incomingGoodDataLimit == 0);
 
-	const auto incoming = bytes::make_detached_span(_incoming);
-	if (incoming.size() > amount) {
-		bytes::move(incoming, incoming.subspan(amount));
-		_incoming.chop(amount);
+	// Consumed bytes are only skipped here, the actual memmove is done
+	// in compactIncoming() when enough garbage was accumulated.
+	if (incomingSize() > amount) {
+		_incomingStart += amount;
 	} else {
 		_incoming.clear();
+		_incomingStart = 0;
 	}
 }
 
+void TlsSocket::compactIncoming() {
+	if (!_incomingStart) {
+		return;
+	} else if (_incomingStart < kIncomingCompactThreshold
+		&& _incomingStart * 2 < _incoming.size()) {
+		return;
+	}
+	const auto incoming = bytes::make_detached_span(_incoming);
+	bytes::move(incoming, incoming.subspan(_incomingStart));
+	_incoming.chop(base::take(_incomingStart));
+}
+
 void TlsSocket::connectToHost(const QString &address, int port) {
 	Expects(_state == State::NotConnected);
 
@@ -693,7 +713,7 @@ bool TlsSocket::isConnected() {
 
 bool TlsSocket::hasBytesAvailable() {
 	return (_incomingGoodDataLimit > 0)
-		&& (_incomingGoodDataOffset < _incoming.size());
+		&& (_incomingGoodDataOffset < incomingSize());
 }
 
 int64 TlsSocket::read(bytes::span buffer) {
@@ -701,7 +721,7 @@ int64 TlsSocket::read(bytes::span buffer) {
 	while (_incomingGoodDataLimit) {
 		const auto available = std::min(
 			_incomingGoodDataLimit,
-			_incoming.size() - _incomingGoodDataOffset);
+			incomingSize() - _incomingGoodDataOffset);
 		if (available <= 0) {
 			return written;
 		}
@@ -712,7 +732,7 @@ int64 TlsSocket::read(bytes::span buffer) {
 		bytes::copy(
 			buffer,
 			bytes::make_span(_incoming).subspan(
-				_incomingGoodDataOffset,
+				_incomingStart + _incomingGoodDataOffset,
 				write));
 		written += write;
 		buffer = buffer.subspan(write);
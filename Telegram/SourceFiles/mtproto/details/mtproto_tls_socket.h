@@ -51,12 +51,15 @@ private:
 	void checkHelloDigest();
 	void readData();
 	[[nodiscard]] bool checkNextPacket();
+	[[nodiscard]] int incomingSize() const;
 	void shiftIncomingBy(int amount);
+	void compactIncoming();
 
 	const bytes::vector _secret;
 	QTcpSocket _socket;
 	State _state = State::NotConnected;
 	QByteArray _incoming;
+	int _incomingStart = 0;
 	int _incomingGoodDataOffset = 0;
 	int _incomingGoodDataLimit = 0;
 	int16 _serverHelloLength = 0;
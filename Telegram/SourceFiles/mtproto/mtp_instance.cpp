@@ -8,10 +8,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtp_instance.h"
 
 #include "mtproto/details/mtproto_dcenter.h"
+#include "mtproto/details/mtproto_request_slots.h"
 #include "mtproto/details/mtproto_rsa_public_key.h"
 #include "mtproto/special_config_request.h"
 #include "mtproto/session.h"
 #include "mtproto/mtproto_config.h"
+#include "mtproto/mtp_request_stats.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "mtproto/config_loader.h"
 #include "mtproto/sender.h"
@@ -239,21 +241,21 @@ private:
 	rpl::event_stream<> _allKeysDestroyed;
 
 	// holds dcWithShift for request to this dc or -dc for request to main dc
-	std::map<mtpRequestId, ShiftedDcId> _requestsByDc;
+	RequestSlots<ShiftedDcId> _requestsByDc;
 	mutable QMutex _requestByDcLock;
 
 	// holds target dcWithShift for auth export request
 	std::map<mtpRequestId, ShiftedDcId> _authExportRequests;
 
-	std::map<mtpRequestId, RPCResponseHandler> _parserMap;
+	RequestSlots<RPCResponseHandler> _parserMap;
 	QMutex _parserMapLock;
 
-	std::map<mtpRequestId, SerializedRequest> _requestMap;
+	RequestSlots<SerializedRequest> _requestMap;
 	QReadWriteLock _requestMapLock;
 
 	std::deque<std::pair<mtpRequestId, crl::time>> _delayedRequests;
 
-	std::map<mtpRequestId, int> _requestsDelays;
+	RequestSlots<int> _requestsDelays;
 
 	std::set<mtpRequestId> _badGuestDcRequests;
 
@@ -585,10 +587,9 @@ void Instance::Private::cancel(mtpRequestId requestId) {
 	auto msgId = mtpMsgId(0);
 	{
 		QWriteLocker locker(&_requestMapLock);
-		auto it = _requestMap.find(requestId);
-		if (it != _requestMap.end()) {
-			msgId = *(mtpMsgId*)(it->second->constData() + 4);
-			_requestMap.erase(it);
+		if (const auto request = _requestMap.find(requestId)) {
+			msgId = *(mtpMsgId*)((*request)->constData() + 4);
+			_requestMap.erase(requestId);
 		}
 	}
 	unregisterRequest(requestId);
@@ -873,9 +874,8 @@ bool Instance::Private::configLoadFail(const RPCError &error) {
 std::optional<ShiftedDcId> Instance::Private::queryRequestByDc(
 		mtpRequestId requestId) const {
 	QMutexLocker locker(&_requestByDcLock);
-	auto it = _requestsByDc.find(requestId);
-	if (it != _requestsByDc.cend()) {
-		return it->second;
+	if (const auto shiftedDcId = _requestsByDc.find(requestId)) {
+		return *shiftedDcId;
 	}
 	return std::nullopt;
 }
@@ -884,14 +884,13 @@ std::optional<ShiftedDcId> Instance::Private::changeRequestByDc(
 		mtpRequestId requestId,
 		DcId newdc) {
 	QMutexLocker locker(&_requestByDcLock);
-	auto it = _requestsByDc.find(requestId);
-	if (it != _requestsByDc.cend()) {
-		if (it->second < 0) {
-			it->second = -newdc;
+	if (const auto shiftedDcId = _requestsByDc.find(requestId)) {
+		if (*shiftedDcId < 0) {
+			*shiftedDcId = -newdc;
 		} else {
-			it->second = ShiftDcId(newdc, GetDcIdShift(it->second));
+			*shiftedDcId = ShiftDcId(newdc, GetDcIdShift(*shiftedDcId));
 		}
-		return it->second;
+		return *shiftedDcId;
 	}
 	return std::nullopt;
 }
@@ -913,12 +912,12 @@ void Instance::Private::checkDelayedRequests() {
 		auto request = SerializedRequest();
 		{
 			QReadLocker locker(&_requestMapLock);
-			auto it = _requestMap.find(requestId);
-			if (it == _requestMap.cend()) {
+			const auto found = _requestMap.find(requestId);
+			if (!found) {
 				DEBUG_LOG(("MTP Error: could not find request %1").arg(requestId));
 				continue;
 			}
-			request = it->second;
+			request = *found;
 		}
 		const auto session = getSession(qAbs(dcWithShift));
 		session->sendPrepared(request);
@@ -941,6 +940,14 @@ void Instance::Private::sendRequest(
 
 	request->requestId = requestId;
 	storeRequest(requestId, request, std::move(callbacks));
+	if (RequestStats::Enabled()) {
+		const auto position = SerializedRequest::kMessageBodyPosition;
+		RequestStats::Sent(
+			requestId,
+			((request->size() > position)
+				? mtpTypeId((*request)[position])
+				: mtpTypeId(0)));
+	}
 
 	const auto toMainDc = (shiftedDcId == 0);
 	const auto realShiftedDcId = session->getDcWithShift();
@@ -960,13 +967,14 @@ void Instance::Private::registerRequest(
 		mtpRequestId requestId,
 		ShiftedDcId shiftedDcId) {
 	QMutexLocker locker(&_requestByDcLock);
-	_requestsByDc[requestId] = shiftedDcId;
+	_requestsByDc.set(requestId, shiftedDcId);
 }
 
 void Instance::Private::unregisterRequest(mtpRequestId requestId) {
 	DEBUG_LOG(("MTP Info: unregistering request %1.").arg(requestId));
 
 	_requestsDelays.erase(requestId);
+	RequestStats::Forget(requestId);
 
 	{
 		QWriteLocker locker(&_requestMapLock);
@@ -983,11 +991,11 @@ void Instance::Private::storeRequest(
 		RPCResponseHandler &&callbacks) {
 	if (callbacks.onDone || callbacks.onFail) {
 		QMutexLocker locker(&_parserMapLock);
-		_parserMap.emplace(requestId, std::move(callbacks));
+		_parserMap.set(requestId, std::move(callbacks));
 	}
 	{
 		QWriteLocker locker(&_requestMapLock);
-		_requestMap.emplace(requestId, request);
+		_requestMap.set(requestId, request);
 	}
 }
 
@@ -995,9 +1003,8 @@ SerializedRequest Instance::Private::getRequest(mtpRequestId requestId) {
 	auto result = SerializedRequest();
 	{
 		QReadLocker locker(&_requestMapLock);
-		auto it = _requestMap.find(requestId);
-		if (it != _requestMap.cend()) {
-			result = it->second;
+		if (const auto request = _requestMap.find(requestId)) {
+			result = *request;
 		}
 	}
 	return result;
@@ -1008,13 +1015,22 @@ void Instance::Private::execCallback(
 		mtpRequestId requestId,
 		const mtpPrime *from,
 		const mtpPrime *end) {
+	const auto statsType = RequestStats::Received(
+		requestId,
+		(end - from) * sizeof(mtpPrime));
+	const auto statsStarted = statsType ? crl::profile() : 0;
+	const auto statsGuard = gsl::finally([&] {
+		if (statsType) {
+			RequestStats::Handled(statsType, crl::profile() - statsStarted);
+		}
+	});
+
 	RPCResponseHandler h;
 	{
 		QMutexLocker locker(&_parserMapLock);
-		auto it = _parserMap.find(requestId);
-		if (it != _parserMap.cend()) {
-			h = it->second;
-			_parserMap.erase(it);
+		if (const auto handler = _parserMap.find(requestId)) {
+			h = std::move(*handler);
+			_parserMap.erase(requestId);
 
 			DEBUG_LOG(("RPC Info: found parser for request %1, trying to parse response...").arg(requestId));
 		}
@@ -1030,7 +1046,7 @@ void Instance::Private::execCallback(
 				unregisterRequest(requestId);
 			} else {
 				QMutexLocker locker(&_parserMapLock);
-				_parserMap.emplace(requestId, h);
+				_parserMap.set(requestId, h);
 			}
 		};
 
@@ -1061,8 +1077,7 @@ void Instance::Private::execCallback(
 
 bool Instance::Private::hasCallbacks(mtpRequestId requestId) {
 	QMutexLocker locker(&_parserMapLock);
-	auto it = _parserMap.find(requestId);
-	return (it != _parserMap.cend());
+	return _parserMap.contains(requestId);
 }
 
 void Instance::Private::globalCallback(const mtpPrime *from, const mtpPrime *end) {
@@ -1124,8 +1139,7 @@ void Instance::Private::importDone(const MTPauth_Authorization &result, mtpReque
 	if (waiters.size()) {
 		QReadLocker locker(&_requestMapLock);
 		for (auto waitedRequestId : waiters) {
-			auto it = _requestMap.find(waitedRequestId);
-			if (it == _requestMap.cend()) {
+			if (!_requestMap.contains(waitedRequestId)) {
 				LOG(("MTP Error: could not find request %1 for resending").arg(waitedRequestId));
 				continue;
 			}
@@ -1247,12 +1261,12 @@ bool Instance::Private::onErrorDefault(mtpRequestId requestId, const RPCError &e
 		auto request = SerializedRequest();
 		{
 			QReadLocker locker(&_requestMapLock);
-			auto it = _requestMap.find(requestId);
-			if (it == _requestMap.cend()) {
+			const auto found = _requestMap.find(requestId);
+			if (!found) {
 				LOG(("MTP Error: could not find request %1").arg(requestId));
 				return false;
 			}
-			request = it->second;
+			request = *found;
 		}
 		const auto session = getSession(newdcWithShift);
 		registerRequest(
@@ -1265,11 +1279,10 @@ bool Instance::Private::onErrorDefault(mtpRequestId requestId, const RPCError &e
 
 		int32 secs = 1;
 		if (code < 0 || code >= 500) {
-			auto it = _requestsDelays.find(requestId);
-			if (it != _requestsDelays.cend()) {
-				secs = (it->second > 60) ? it->second : (it->second *= 2);
+			if (const auto delay = _requestsDelays.find(requestId)) {
+				secs = (*delay > 60) ? *delay : (*delay *= 2);
 			} else {
-				_requestsDelays.emplace(requestId, secs);
+				_requestsDelays.set(requestId, secs);
 			}
 		} else {
 			secs = m.captured(1).toInt();
@@ -1319,12 +1332,12 @@ bool Instance::Private::onErrorDefault(mtpRequestId requestId, const RPCError &e
 		SerializedRequest request;
 		{
 			QReadLocker locker(&_requestMapLock);
-			auto it = _requestMap.find(requestId);
-			if (it == _requestMap.cend()) {
+			const auto found = _requestMap.find(requestId);
+			if (!found) {
 				LOG(("MTP Error: could not find request %1").arg(requestId));
 				return false;
 			}
-			request = it->second;
+			request = *found;
 		}
 		auto dcWithShift = ShiftedDcId(0);
 		if (const auto shiftedDcId = queryRequestByDc(requestId)) {
@@ -1344,12 +1357,12 @@ bool Instance::Private::onErrorDefault(mtpRequestId requestId, const RPCError &e
 		SerializedRequest request;
 		{
 			QReadLocker locker(&_requestMapLock);
-			auto it = _requestMap.find(requestId);
-			if (it == _requestMap.cend()) {
+			const auto found = _requestMap.find(requestId);
+			if (!found) {
 				LOG(("MTP Error: could not find request %1").arg(requestId));
 				return false;
 			}
-			request = it->second;
+			request = *found;
 		}
 		if (!request->after) {
 			LOG(("MTP Error: wait failed for not dependent request %1").arg(requestId));
@@ -0,0 +1,190 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "mtproto/mtp_request_stats.h"
+
+#include "settings.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+namespace MTP::RequestStats {
+namespace {
+
+// Bucket i counts values in [2^(i-1), 2^i), the last one the rest.
+constexpr auto kBucketsCount = 26;
+
+struct Histogram {
+	void add(int64 value);
+	[[nodiscard]] QJsonObject toJson() const;
+
+	std::array<int, kBucketsCount> buckets = { { 0 } };
+	int64 total = 0;
+	int64 max = 0;
+	int count = 0;
+};
+
+struct Method {
+	Histogram latency; // ms, from sending till the response is received.
+	Histogram handler; // mcs, handling the response on the main thread.
+	Histogram bytes;
+};
+
+struct Pending {
+	mtpTypeId type = 0;
+	crl::time sent = 0;
+};
+
+struct State {
+	QMutex mutex;
+	base::flat_map<mtpTypeId, Method> methods;
+	base::flat_map<mtpRequestId, Pending> pending;
+};
+
+std::atomic<bool> IsEnabled = false;
+State Collected;
+
+void Histogram::add(int64 value) {
+	auto bucket = 0;
+	while (bucket + 1 < kBucketsCount && (int64(1) << bucket) <= value) {
+		++bucket;
+	}
+	++buckets[bucket];
+	total += value;
+	accumulate_max(max, value);
+	++count;
+}
+
+QJsonObject Histogram::toJson() const {
+	auto list = QJsonArray();
+	for (const auto count : buckets) {
+		list.push_back(count);
+	}
+	auto result = QJsonObject();
+	result.insert("count", count);
+	result.insert("total", double(total));
+	result.insert("max", double(max));
+	result.insert("buckets", list);
+	return result;
+}
+
+[[nodiscard]] QString TypeName(mtpTypeId type) {
+	return "0x" + QString::number(type, 16).rightJustified(8, '0');
+}
+
+} // namespace
+
+void Enable() {
+	IsEnabled = true;
+}
+
+bool Enabled() {
+	return IsEnabled;
+}
+
+void Sent(mtpRequestId requestId, mtpTypeId type) {
+	if (!Enabled()) {
+		return;
+	}
+	QMutexLocker lock(&Collected.mutex);
+	Collected.pending[requestId] = { type, crl::now() };
+}
+
+mtpTypeId Received(mtpRequestId requestId, int bytes) {
+	if (!Enabled()) {
+		return 0;
+	}
+	QMutexLocker lock(&Collected.mutex);
+	const auto i = Collected.pending.find(requestId);
+	if (i == end(Collected.pending)) {
+		return 0;
+	}
+	const auto [type, sent] = i->second;
+	Collected.pending.erase(i);
+
+	auto &method = Collected.methods[type];
+	method.latency.add(crl::now() - sent);
+	method.bytes.add(bytes);
+	return type;
+}
+
+void Handled(mtpTypeId type, crl::profile_time duration) {
+	if (!Enabled() || !type) {
+		return;
+	}
+	QMutexLocker lock(&Collected.mutex);
+	Collected.methods[type].handler.add(duration);
+}
+
+void Forget(mtpRequestId requestId) {
+	if (!Enabled()) {
+		return;
+	}
+	QMutexLocker lock(&Collected.mutex);
+	Collected.pending.remove(requestId);
+}
+
+QString Summary(int limit) {
+	QMutexLocker lock(&Collected.mutex);
+	auto sorted = std::vector<std::pair<mtpTypeId, const Method*>>();
+	sorted.reserve(Collected.methods.size());
+	for (const auto &[type, method] : Collected.methods) {
+		sorted.emplace_back(type, &method);
+	}
+	ranges::sort(sorted, ranges::greater(), [](const auto &pair) {
+		return pair.second->latency.total;
+	});
+	auto result = QStringList();
+	for (const auto &[type, method] : sorted) {
+		if (result.size() == limit) {
+			break;
+		}
+		const auto &latency = method->latency;
+		if (!latency.count) {
+			continue;
+		}
+		result.push_back(qsl("%1: %2 x %3 ms avg, %4 ms max, %5 KB, %6 mcs"
+			).arg(TypeName(type)
+			).arg(latency.count
+			).arg(latency.total / latency.count
+			).arg(latency.max
+			).arg(method->bytes.total / 1024
+			).arg(method->handler.count
+				? (method->handler.total / method->handler.count)
+				: 0));
+	}
+	return result.join('\n');
+}
+
+QString Dump() {
+	auto methods = QJsonObject();
+	{
+		QMutexLocker lock(&Collected.mutex);
+		for (const auto &[type, method] : Collected.methods) {
+			auto object = QJsonObject();
+			object.insert("latency_ms", method.latency.toJson());
+			object.insert("handler_mcs", method.handler.toJson());
+			object.insert("response_bytes", method.bytes.toJson());
+			methods.insert(TypeName(type), object);
+		}
+	}
+	auto root = QJsonObject();
+	root.insert("methods", methods);
+
+	const auto path = cWorkingDir() + qsl("tdata/rpc_stats.json");
+	auto f = QFile(path);
+	if (!f.open(QIODevice::WriteOnly)) {
+		LOG(("RPC Stats Error: could not write '%1'.").arg(path));
+		return QString();
+	}
+	f.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+	LOG(("RPC Stats: written to '%1'.").arg(path));
+	return path;
+}
+
+} // namespace MTP::RequestStats
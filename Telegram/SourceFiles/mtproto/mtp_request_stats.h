@@ -0,0 +1,30 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace MTP::RequestStats {
+
+// Per-method statistics of requests, collected only after Enable().
+// Methods are identified by the constructor of the sent request.
+void Enable();
+[[nodiscard]] bool Enabled();
+
+void Sent(mtpRequestId requestId, mtpTypeId type);
+
+// Returns the method of the request or zero if it was not tracked.
+mtpTypeId Received(mtpRequestId requestId, int bytes);
+void Handled(mtpTypeId type, crl::profile_time duration);
+void Forget(mtpRequestId requestId);
+
+// Methods with the largest total latency, one per line.
+[[nodiscard]] QString Summary(int limit);
+
+// Writes all collected histograms to 'tdata/rpc_stats.json'.
+[[nodiscard]] QString Dump();
+
+} // namespace MTP::RequestStats
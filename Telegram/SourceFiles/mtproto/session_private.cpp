@@ -1231,19 +1231,28 @@ void SessionPrivate::handleReceived() {
 			return restart();
 		}
 
-		auto encryptedInts = ints + kExternalHeaderIntsCount;
 		auto encryptedIntsCount = (intsCount - kExternalHeaderIntsCount) & ~0x03U;
 		auto encryptedBytesCount = encryptedIntsCount * kIntSize;
-		auto decryptedBuffer = QByteArray(encryptedBytesCount, Qt::Uninitialized);
 		auto msgKey = *(MTPint128*)(ints + 2);
 
+		// We own intsBuffer here, so decrypt it in place (IGE allows that)
+		// instead of allocating a separate buffer for every packet.
+		const auto decryptedInts = intsBuffer.data() + kExternalHeaderIntsCount;
+
+		// After the in-place decryption only the external header is left
+		// as it was received, so label the rest of the dump as decrypted.
+		const auto logBadDecrypted = [&] {
+			TCP_LOG(("TCP Error: bad message header %1, decrypted %2"
+				).arg(Logs::mb(ints, kExternalHeaderIntsCount * kIntSize).str()
+				).arg(Logs::mb(decryptedInts, encryptedBytesCount).str()));
+		};
+
 #ifdef TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt_oldmtp(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		aesIgeDecrypt_oldmtp(decryptedInts, decryptedInts, encryptedBytesCount, _encryptionKey, msgKey);
 #else // TDESKTOP_MTPROTO_OLD
-		aesIgeDecrypt(encryptedInts, decryptedBuffer.data(), encryptedBytesCount, _encryptionKey, msgKey);
+		aesIgeDecrypt(decryptedInts, decryptedInts, encryptedBytesCount, _encryptionKey, msgKey);
 #endif // TDESKTOP_MTPROTO_OLD
 
-		auto decryptedInts = reinterpret_cast<const mtpPrime*>(decryptedBuffer.constData());
 		auto serverSalt = *(uint64*)&decryptedInts[0];
 		auto session = *(uint64*)&decryptedInts[2];
 		auto msgId = *(uint64*)&decryptedInts[4];
@@ -1253,7 +1262,7 @@ void SessionPrivate::handleReceived() {
 		auto messageLength = *(uint32*)&decryptedInts[7];
 		if (messageLength > kMaxMessageLength) {
 			LOG(("TCP Error: bad messageLength %1").arg(messageLength));
-			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(ints, intsCount * kIntSize).str()));
+			logBadDecrypted();
 
 			return restart();
 
@@ -1274,7 +1283,7 @@ void SessionPrivate::handleReceived() {
 		constexpr auto kMsgKeyShift_oldmtp = 4U;
 		if (ConstTimeIsDifferent(&msgKey, sha1ForMsgKeyCheck.data() + kMsgKeyShift_oldmtp, sizeof(msgKey))) {
 			LOG(("TCP Error: bad SHA1 hash after aesDecrypt in message."));
-			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(encryptedInts, encryptedBytesCount).str()));
+			logBadDecrypted();
 
 			return restart();
 		}
@@ -1294,7 +1303,7 @@ void SessionPrivate::handleReceived() {
 		constexpr auto kMsgKeyShift = 8U;
 		if (ConstTimeIsDifferent(&msgKey, sha256Buffer.data() + kMsgKeyShift, sizeof(msgKey))) {
 			LOG(("TCP Error: bad SHA256 hash after aesDecrypt in message"));
-			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(encryptedInts, encryptedBytesCount).str()));
+			logBadDecrypted();
 
 			return restart();
 		}
@@ -1302,7 +1311,7 @@ void SessionPrivate::handleReceived() {
 
 		if (badMessageLength || (messageLength & 0x03)) {
 			LOG(("TCP Error: bad msg_len received %1, data size: %2").arg(messageLength).arg(encryptedBytesCount));
-			TCP_LOG(("TCP Error: bad message %1").arg(Logs::mb(encryptedInts, encryptedBytesCount).str()));
+			logBadDecrypted();
 
 			return restart();
 		}
@@ -348,6 +348,7 @@ void Photo::paint(Painter &p, const QRect &clip, TextSelection selection, const
 
 	if (_pix.isNull()) {
 		p.fillRect(0, 0, _width, _height, st::overviewPhotoBg);
+		delegate()->paintedWithoutThumbnail(this);
 	} else {
 		p.drawPixmap(0, 0, _pix);
 	}
@@ -400,6 +401,10 @@ void Photo::ensureDataMediaCreated() const {
 	delegate()->registerHeavyItem(this);
 }
 
+void Photo::preloadThumbnail() {
+	ensureDataMediaCreated();
+}
+
 void Photo::clearHeavyPart() {
 	_dataMedia = nullptr;
 }
@@ -482,6 +487,7 @@ void Video::paint(Painter &p, const QRect &clip, TextSelection selection, const
 
 	if (_pix.isNull()) {
 		p.fillRect(0, 0, _width, _height, st::overviewPhotoBg);
+		delegate()->paintedWithoutThumbnail(this);
 	} else {
 		p.drawPixmap(0, 0, _pix);
 	}
@@ -555,6 +561,10 @@ void Video::ensureDataMediaCreated() const {
 	delegate()->registerHeavyItem(this);
 }
 
+void Video::preloadThumbnail() {
+	ensureDataMediaCreated();
+}
+
 void Video::clearHeavyPart() {
 	_dataMedia = nullptr;
 }
@@ -71,6 +71,9 @@ public:
 
 	virtual void clearHeavyPart() {
 	}
+	// Starts loading the thumbnail before the item is painted.
+	virtual void preloadThumbnail() {
+	}
 
 protected:
 	[[nodiscard]] not_null<HistoryItem*> parent() const {
@@ -188,6 +191,7 @@ public:
 		StateRequest request) const override;
 
 	void clearHeavyPart() override;
+	void preloadThumbnail() override;
 
 private:
 	void ensureDataMediaCreated() const;
@@ -218,6 +222,7 @@ public:
 		StateRequest request) const override;
 
 	void clearHeavyPart() override;
+	void preloadThumbnail() override;
 
 protected:
 	float64 dataProgress() const override;
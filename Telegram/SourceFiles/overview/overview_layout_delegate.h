@@ -16,6 +16,8 @@ class Delegate {
 public:
 	virtual void registerHeavyItem(not_null<const ItemBase*> item) = 0;
 	virtual void unregisterHeavyItem(not_null<const ItemBase*> item) = 0;
+	virtual void paintedWithoutThumbnail(
+		not_null<const ItemBase*> item) = 0;
 
 };
 
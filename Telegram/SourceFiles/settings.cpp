@@ -54,6 +54,7 @@ uint32 gConnectionsInSession = 1;
 QByteArray gLocalSalt;
 int gScreenScale = style::kScaleAuto;
 int gConfigScale = style::kScaleAuto;
+int gPixmapCacheMegabytes = 192;
 
 QString gTimeFormat = qsl("hh:mm");
 
@@ -93,6 +93,7 @@ DeclareReadSetting(bool, ManyInstance);
 DeclareSetting(QByteArray, LocalSalt);
 DeclareSetting(int, ScreenScale);
 DeclareSetting(int, ConfigScale);
+DeclareSetting(int, PixmapCacheMegabytes);
 DeclareSetting(QString, TimeFormat);
 
 using RecentEmojiPreloadOldOld = QVector<QPair<uint32, ushort>>;
@@ -20,6 +20,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "lang/lang_instance.h"
 #include "core/application.h"
 #include "mtproto/mtp_instance.h"
+#include "mtproto/mtp_request_stats.h"
 #include "mtproto/mtproto_dc_options.h"
 #include "core/file_utilities.h"
 #include "core/update_checker.h"
@@ -46,6 +47,24 @@ auto GenerateCodes() {
 			Core::App().switchDebugMode();
 		}));
 	});
+	codes.emplace(qsl("rpcstats"), [](SessionController *window) {
+		if (!MTP::RequestStats::Enabled()) {
+			const auto text = qsl("Do you want to collect RPC statistics?\n\n"
+				"Type the code again to see and save them.");
+			Ui::show(Box<ConfirmBox>(text, [] {
+				MTP::RequestStats::Enable();
+				Ui::hideLayer();
+			}));
+			return;
+		}
+		const auto path = MTP::RequestStats::Dump();
+		const auto summary = MTP::RequestStats::Summary(10);
+		Ui::show(Box<InformBox>((summary.isEmpty()
+			? qsl("No requests yet.")
+			: summary) + (path.isEmpty()
+				? QString()
+				: ("\n\nSaved to " + path))));
+	});
 	codes.emplace(qsl("viewlogs"), [](SessionController *window) {
 		File::ShowInFolder(cWorkingDir() + "log.txt");
 	});
@@ -21,8 +21,118 @@ namespace {
 constexpr char TdfMagic[] = { 'T', 'D', 'F', '$' };
 constexpr auto TdfMagicLen = int(sizeof(TdfMagic));
 
+constexpr auto kTdfHeaderLen = TdfMagicLen + int(sizeof(qint32));
+
 constexpr auto kStrongIterationsCount = 100'000;
 
+struct CheckedFileData {
+	int32 version = 0;
+	int32 size = 0;
+};
+
+// Checks magic, version and signature of the file contents,
+// 'data' points to the data part followed by the signature.
+[[nodiscard]] std::optional<CheckedFileData> CheckFileData(
+		const QString &name,
+		const char *header,
+		const char *data,
+		qint64 size) {
+	const auto magic = header;
+	if (memcmp(magic, TdfMagic, TdfMagicLen)) {
+		DEBUG_LOG(("App Info: bad magic %1 in '%2'"
+			).arg(Logs::mb(magic, TdfMagicLen).str()
+			).arg(name));
+		return std::nullopt;
+	}
+
+	// read app version
+	qint32 version;
+	memcpy(&version, header + TdfMagicLen, sizeof(version));
+	if (version > AppVersion) {
+		DEBUG_LOG(("App Info: version too big %1 for '%2', my version %3"
+			).arg(version
+			).arg(name
+			).arg(AppVersion));
+		return std::nullopt;
+	}
+
+	int32 dataSize = size - 16;
+	if (dataSize < 0) {
+		DEBUG_LOG(("App Info: bad file '%1', could not read sign part"
+			).arg(name));
+		return std::nullopt;
+	}
+
+	// check signature
+	HashMd5 md5;
+	md5.feed(data, dataSize);
+	md5.feed(&dataSize, sizeof(dataSize));
+	md5.feed(&version, sizeof(version));
+	md5.feed(magic, TdfMagicLen);
+	if (memcmp(md5.result(), data + dataSize, 16)) {
+		DEBUG_LOG(("App Info: bad file '%1', signature did not match"
+			).arg(name));
+		return std::nullopt;
+	}
+	return CheckedFileData{ version, dataSize };
+}
+
+// Tries the file variants in the right order, 'method' reads an opened one.
+template <typename Method>
+bool TryReadFile(
+		const QString &name,
+		const QString &basePath,
+		Method &&method) {
+	const auto base = basePath + name;
+
+	// detect order of read attempts
+	QString toTry[2];
+	const auto modern = base + 's';
+	if (QFileInfo(modern).exists()) {
+		toTry[0] = modern;
+	} else {
+		// Legacy way.
+		toTry[0] = base + '0';
+		QFileInfo toTry0(toTry[0]);
+		if (toTry0.exists()) {
+			toTry[1] = basePath + name + '1';
+			QFileInfo toTry1(toTry[1]);
+			if (toTry1.exists()) {
+				QDateTime mod0 = toTry0.lastModified();
+				QDateTime mod1 = toTry1.lastModified();
+				if (mod0 < mod1) {
+					qSwap(toTry[0], toTry[1]);
+				}
+			} else {
+				toTry[1] = QString();
+			}
+		} else {
+			toTry[0][toTry[0].size() - 1] = '1';
+		}
+	}
+	for (int32 i = 0; i < 2; ++i) {
+		QString fname(toTry[i]);
+		if (fname.isEmpty()) break;
+
+		QFile f(fname);
+		if (!f.open(QIODevice::ReadOnly)) {
+			DEBUG_LOG(("App Info: failed to open '%1' for reading"
+				).arg(name));
+			continue;
+		} else if (!method(f)) {
+			continue;
+		}
+		f.close();
+
+		if ((i == 0 && !toTry[1].isEmpty()) || i == 1) {
+			QFile::remove(toTry[1 - i]);
+		}
+
+		return true;
+	}
+	return false;
+}
+
 } // namespace
 
 QString ToFilePart(FileKey val) {
@@ -314,126 +424,52 @@ bool ReadFile(
 		FileReadDescriptor &result,
 		const QString &name,
 		const QString &basePath) {
-	const auto base = basePath + name;
-
-	// detect order of read attempts
-	QString toTry[2];
-	const auto modern = base + 's';
-	if (QFileInfo(modern).exists()) {
-		toTry[0] = modern;
-	} else {
-		// Legacy way.
-		toTry[0] = base + '0';
-		QFileInfo toTry0(toTry[0]);
-		if (toTry0.exists()) {
-			toTry[1] = basePath + name + '1';
-			QFileInfo toTry1(toTry[1]);
-			if (toTry1.exists()) {
-				QDateTime mod0 = toTry0.lastModified();
-				QDateTime mod1 = toTry1.lastModified();
-				if (mod0 < mod1) {
-					qSwap(toTry[0], toTry[1]);
-				}
-			} else {
-				toTry[1] = QString();
-			}
-		} else {
-			toTry[0][toTry[0].size() - 1] = '1';
-		}
-	}
-	for (int32 i = 0; i < 2; ++i) {
-		QString fname(toTry[i]);
-		if (fname.isEmpty()) break;
-
-		QFile f(fname);
-		if (!f.open(QIODevice::ReadOnly)) {
-			DEBUG_LOG(("App Info: failed to open '%1' for reading"
-				).arg(name));
-			continue;
-		}
-
-		// check magic
-		char magic[TdfMagicLen];
-		if (f.read(magic, TdfMagicLen) != TdfMagicLen) {
-			DEBUG_LOG(("App Info: failed to read magic from '%1'"
-				).arg(name));
-			continue;
-		}
-		if (memcmp(magic, TdfMagic, TdfMagicLen)) {
-			DEBUG_LOG(("App Info: bad magic %1 in '%2'"
-				).arg(Logs::mb(magic, TdfMagicLen).str()
-				).arg(name));
-			continue;
-		}
-
-		// read app version
-		qint32 version;
-		if (f.read((char*)&version, sizeof(version)) != sizeof(version)) {
-			DEBUG_LOG(("App Info: failed to read version from '%1'"
+	return TryReadFile(name, basePath, [&](QFile &f) {
+		char header[kTdfHeaderLen];
+		if (f.read(header, kTdfHeaderLen) != kTdfHeaderLen) {
+			DEBUG_LOG(("App Info: failed to read header from '%1'"
 				).arg(name));
-			continue;
-		}
-		if (version > AppVersion) {
-			DEBUG_LOG(("App Info: version too big %1 for '%2', my version %3"
-				).arg(version
-				).arg(name
-				).arg(AppVersion));
-			continue;
+			return false;
 		}
 
 		// read data
 		QByteArray bytes = f.read(f.size());
-		int32 dataSize = bytes.size() - 16;
-		if (dataSize < 0) {
-			DEBUG_LOG(("App Info: bad file '%1', could not read sign part"
-				).arg(name));
-			continue;
-		}
-
-		// check signature
-		HashMd5 md5;
-		md5.feed(bytes.constData(), dataSize);
-		md5.feed(&dataSize, sizeof(dataSize));
-		md5.feed(&version, sizeof(version));
-		md5.feed(magic, TdfMagicLen);
-		if (memcmp(md5.result(), bytes.constData() + dataSize, 16)) {
-			DEBUG_LOG(("App Info: bad file '%1', signature did not match"
-				).arg(name));
-			continue;
+		const auto checked = CheckFileData(
+			name,
+			header,
+			bytes.constData(),
+			bytes.size());
+		if (!checked) {
+			return false;
 		}
 
-		bytes.resize(dataSize);
+		bytes.resize(checked->size);
 		result.data = bytes;
 		bytes = QByteArray();
 
-		result.version = version;
+		result.version = checked->version;
 		result.buffer.setBuffer(&result.data);
 		result.buffer.open(QIODevice::ReadOnly);
 		result.stream.setDevice(&result.buffer);
 		result.stream.setVersion(QDataStream::Qt_5_1);
-
-		if ((i == 0 && !toTry[1].isEmpty()) || i == 1) {
-			QFile::remove(toTry[1 - i]);
-		}
-
 		return true;
-	}
-	return false;
+	});
 }
 
 bool DecryptLocal(
-		EncryptedDescriptor &result,
-		const QByteArray &encrypted,
+		QByteArray &result,
+		const char *encrypted,
+		int size,
 		const MTP::AuthKeyPtr &key) {
-	if (encrypted.size() <= 16 || (encrypted.size() & 0x0F)) {
-		LOG(("App Error: bad encrypted part size: %1").arg(encrypted.size()));
+	if (size <= 16 || (size & 0x0F)) {
+		LOG(("App Error: bad encrypted part size: %1").arg(size));
 		return false;
 	}
-	uint32 fullLen = encrypted.size() - 16;
+	uint32 fullLen = size - 16;
 
 	QByteArray decrypted;
 	decrypted.resize(fullLen);
-	const char *encryptedKey = encrypted.constData(), *encryptedData = encrypted.constData() + 16;
+	const char *encryptedKey = encrypted, *encryptedData = encrypted + 16;
 	aesDecryptLocal(encryptedData, decrypted.data(), fullLen, key, encryptedKey);
 	uchar sha1Buffer[20];
 	if (memcmp(hashSha1(decrypted.constData(), decrypted.size(), sha1Buffer), encryptedKey, 16)) {
@@ -448,8 +484,21 @@ bool DecryptLocal(
 	}
 
 	decrypted.resize(dataLen);
-	result.data = decrypted;
-	decrypted = QByteArray();
+	result = std::move(decrypted);
+	return true;
+}
+
+bool DecryptLocal(
+		EncryptedDescriptor &result,
+		const QByteArray &encrypted,
+		const MTP::AuthKeyPtr &key) {
+	if (!DecryptLocal(
+			result.data,
+			encrypted.constData(),
+			encrypted.size(),
+			key)) {
+		return false;
+	}
 
 	result.buffer.setBuffer(&result.data);
 	result.buffer.open(QIODevice::ReadOnly);
@@ -460,39 +509,106 @@ bool DecryptLocal(
 	return true;
 }
 
-bool ReadEncryptedFile(
-		FileReadDescriptor &result,
+std::optional<DecryptedFile> ReadDecryptedFile(
 		const QString &name,
 		const QString &basePath,
 		const MTP::AuthKeyPtr &key) {
-	if (!ReadFile(result, name, basePath)) {
-		return false;
-	}
-	QByteArray encrypted;
-	result.stream >> encrypted;
-
-	EncryptedDescriptor data;
-	if (!DecryptLocal(data, encrypted, key)) {
-		result.stream.setDevice(nullptr);
-		if (result.buffer.isOpen()) result.buffer.close();
-		result.buffer.setBuffer(nullptr);
-		result.data = QByteArray();
-		result.version = 0;
-		return false;
+	const auto started = crl::now();
+
+	auto result = std::optional<DecryptedFile>();
+	auto mappingFailed = false;
+	const auto mapped = TryReadFile(name, basePath, [&](QFile &f) {
+		// Decrypt right from the mapped file to skip the intermediate
+		// copies of the whole file and of the encrypted part.
+		const auto size = f.size();
+		if (size <= kTdfHeaderLen) {
+			DEBUG_LOG(("App Info: failed to read header from '%1'"
+				).arg(name));
+			return false;
+		}
+		const auto data = reinterpret_cast<const char*>(f.map(0, size));
+		if (!data) {
+			mappingFailed = true;
+			return false;
+		}
+		const auto checked = CheckFileData(
+			name,
+			data,
+			data + kTdfHeaderLen,
+			size - kTdfHeaderLen);
+		if (!checked || checked->size < int(sizeof(quint32))) {
+			return false;
+		}
+
+		// Same layout as QDataStream writes a QByteArray.
+		const auto encrypted = data + kTdfHeaderLen;
+		const auto length = qFromBigEndian<quint32>(encrypted);
+		if (length > uint32(checked->size - sizeof(quint32))) {
+			DEBUG_LOG(("App Info: bad encrypted part in '%1'").arg(name));
+			return false;
+		}
+		auto decrypted = QByteArray();
+		if (!DecryptLocal(
+				decrypted,
+				encrypted + sizeof(quint32),
+				int(length),
+				key)) {
+			return false;
+		}
+		result = DecryptedFile{ checked->version, std::move(decrypted) };
+		return true;
+	});
+	if (!mapped && !mappingFailed) {
+		return std::nullopt;
+	} else if (!mapped) {
+		// Mapping may be unavailable, fall back to the plain reading.
+		FileReadDescriptor file;
+		if (!ReadFile(file, name, basePath)) {
+			return std::nullopt;
+		}
+		QByteArray encrypted;
+		file.stream >> encrypted;
+
+		EncryptedDescriptor data;
+		if (!DecryptLocal(data, encrypted, key)) {
+			return std::nullopt;
+		}
+		result = DecryptedFile{ file.version, std::move(data.data) };
 	}
+	DEBUG_LOG(("App Info: read and decrypted '%1', %2 bytes in %3 ms%4."
+		).arg(name
+		).arg(result->data.size()
+		).arg(crl::now() - started
+		).arg(mapped ? " (mapped)" : ""));
 
-	result.stream.setDevice(0);
+	return result;
+}
+
+void OpenDecryptedFile(FileReadDescriptor &result, DecryptedFile &&file) {
+	result.stream.setDevice(nullptr);
 	if (result.buffer.isOpen()) {
 		result.buffer.close();
 	}
-	result.buffer.setBuffer(0);
-	result.data = data.data;
+	result.buffer.setBuffer(nullptr);
+	result.version = file.version;
+	result.data = std::move(file.data);
 	result.buffer.setBuffer(&result.data);
 	result.buffer.open(QIODevice::ReadOnly);
-	result.buffer.seek(data.buffer.pos());
+	result.buffer.seek(sizeof(uint32)); // skip len
 	result.stream.setDevice(&result.buffer);
 	result.stream.setVersion(QDataStream::Qt_5_1);
+}
 
+bool ReadEncryptedFile(
+		FileReadDescriptor &result,
+		const QString &name,
+		const QString &basePath,
+		const MTP::AuthKeyPtr &key) {
+	auto file = ReadDecryptedFile(name, basePath, key);
+	if (!file) {
+		return false;
+	}
+	OpenDecryptedFile(result, std::move(*file));
 	return true;
 }
 
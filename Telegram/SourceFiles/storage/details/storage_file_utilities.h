@@ -36,6 +36,12 @@ struct FileReadDescriptor final {
 	QDataStream stream;
 };
 
+// Decrypted contents of a file, can be prepared on any thread.
+struct DecryptedFile final {
+	int32 version = 0;
+	QByteArray data;
+};
+
 struct EncryptedDescriptor final {
 	EncryptedDescriptor();
 	explicit EncryptedDescriptor(uint32 size);
@@ -91,11 +97,23 @@ bool ReadFile(
 	const QString &name,
 	const QString &basePath);
 
+bool DecryptLocal(
+	QByteArray &result,
+	const char *encrypted,
+	int size,
+	const MTP::AuthKeyPtr &key);
 bool DecryptLocal(
 	EncryptedDescriptor &result,
 	const QByteArray &encrypted,
 	const MTP::AuthKeyPtr &key);
 
+[[nodiscard]] std::optional<DecryptedFile> ReadDecryptedFile(
+	const QString &name,
+	const QString &basePath,
+	const MTP::AuthKeyPtr &key);
+
+void OpenDecryptedFile(FileReadDescriptor &result, DecryptedFile &&file);
+
 bool ReadEncryptedFile(
 	FileReadDescriptor &result,
 	const QString &name,
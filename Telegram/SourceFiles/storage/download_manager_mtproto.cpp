@@ -30,6 +30,7 @@ constexpr auto kMaxTrackedSuccesses = kRetryAddSessionSuccesses
 constexpr auto kRemoveSessionAfterTimeouts = 4;
 constexpr auto kResetDownloadPrioritiesTimeout = crl::time(200);
 constexpr auto kBadRequestDurationThreshold = 8 * crl::time(1000);
+constexpr auto kStatsLogPeriod = 10 * crl::time(1000);
 
 // Each (session remove by timeouts) we wait for time:
 // kRetryAddSessionTimeout * max(removesCount, kMaxTrackedSessionRemoves)
@@ -38,27 +39,26 @@ constexpr auto kBadRequestDurationThreshold = 8 * crl::time(1000);
 
 } // namespace
 
+bool DownloadManagerMtproto::Queue::Before(
+		const Enqueued &a,
+		const Enqueued &b) {
+	if (a.priority != b.priority) {
+		return (a.priority > b.priority);
+	} else if (a.deadline && b.deadline) {
+		return (a.deadline < b.deadline);
+	}
+	return (a.deadline != 0) && (b.deadline == 0);
+}
+
 void DownloadManagerMtproto::Queue::enqueue(
 		not_null<Task*> task,
-		int priority) {
-	const auto position = ranges::find_if(_tasks, [&](const Enqueued &task) {
-		return task.priority <= priority;
-	}) - begin(_tasks);
-	const auto now = ranges::find(_tasks, task, &Enqueued::task);
-	const auto i = [&] {
-		if (now != end(_tasks)) {
-			(now->priority = priority);
-			return now;
-		}
-		_tasks.push_back({ task, priority });
-		return end(_tasks) - 1;
-	}();
-	const auto j = begin(_tasks) + position;
-	if (j < i) {
-		std::rotate(j, i, i + 1);
-	} else if (j > i + 1) {
-		std::rotate(i, i + 1, j);
-	}
+		int priority,
+		crl::time deadline) {
+	remove(task);
+
+	const auto enqueued = Enqueued{ task, priority, deadline };
+	const auto position = ranges::lower_bound(_tasks, enqueued, Before);
+	_tasks.insert(position, enqueued);
 }
 
 void DownloadManagerMtproto::Queue::remove(not_null<Task*> task) {
@@ -69,7 +69,7 @@ void DownloadManagerMtproto::Queue::resetGeneration() {
 	const auto from = ranges::find(_tasks, 0, &Enqueued::priority);
 	for (auto &task : ranges::make_subrange(from, end(_tasks))) {
 		if (task.priority) {
-			Assert(task.priority == -1);
+			Assert(task.priority < 0);
 			break;
 		}
 		task.priority = -1;
@@ -81,9 +81,9 @@ bool DownloadManagerMtproto::Queue::empty() const {
 }
 
 auto DownloadManagerMtproto::Queue::nextTask(bool onlyHighestPriority) const
--> Task* {
+-> Next {
 	if (_tasks.empty()) {
-		return nullptr;
+		return {};
 	}
 	const auto highestPriority = _tasks.front().priority;
 	const auto notHighestPriority = [&](const Enqueued &enqueued) {
@@ -98,7 +98,9 @@ auto DownloadManagerMtproto::Queue::nextTask(bool onlyHighestPriority) const
 	const auto first = ranges::find_if(
 		ranges::make_subrange(begin(_tasks), till),
 		readyToRequest);
-	return (first != till) ? first->task.get() : nullptr;
+	return (first != till)
+		? Next{ first->task.get(), first->priority, first->deadline }
+		: Next();
 }
 
 void DownloadManagerMtproto::Queue::removeSession(int index) {
@@ -133,10 +135,13 @@ DownloadManagerMtproto::~DownloadManagerMtproto() {
 	killSessions();
 }
 
-void DownloadManagerMtproto::enqueue(not_null<Task*> task, int priority) {
+void DownloadManagerMtproto::enqueue(
+		not_null<Task*> task,
+		int priority,
+		crl::time deadline) {
 	const auto dcId = task->dcId();
 	auto &queue = _queues[dcId];
-	queue.enqueue(task, priority);
+	queue.enqueue(task, priority, deadline);
 	if (!_resetGenerationTimer.isActive()) {
 		_resetGenerationTimer.callOnce(kResetDownloadPrioritiesTimeout);
 	}
@@ -189,11 +194,32 @@ bool DownloadManagerMtproto::trySendNextPart(MTP::DcId dcId, Queue &queue) {
 		return false;
 	}
 	const auto onlyHighestPriority = (balanceData.totalRequested > 0);
-	if (const auto task = queue.nextTask(onlyHighestPriority)) {
-		task->loadPart(bestIndex);
-		return true;
+	const auto next = queue.nextTask(onlyHighestPriority);
+	if (!next.task) {
+		return false;
 	}
-	return false;
+	next.task->loadPart(bestIndex, next.priority, next.deadline);
+	return true;
+}
+
+void DownloadManagerMtproto::countDeadline(
+		MTP::DcId dcId,
+		int priority,
+		crl::time deadline) {
+	auto &stats = _deadlineStats[priority];
+	const auto late = crl::now() - deadline;
+	if (late <= 0) {
+		++stats.met;
+		return;
+	}
+	++stats.missed;
+	DEBUG_LOG(("Download Info: Part with priority %1 arrived %2 ms "
+		"after deadline in dc %3, missed %4 of %5 with this priority."
+		).arg(priority
+		).arg(late
+		).arg(dcId
+		).arg(stats.missed
+		).arg(stats.met + stats.missed));
 }
 
 int DownloadManagerMtproto::changeRequestedAmount(
@@ -203,8 +229,16 @@ int DownloadManagerMtproto::changeRequestedAmount(
 	const auto i = _balanceData.find(dcId);
 	Assert(i != _balanceData.end());
 	Assert(index < i->second.sessions.size());
-	const auto result = (i->second.sessions[index].requested += delta);
-	i->second.totalRequested += delta;
+	auto &dc = i->second;
+	const auto result = (dc.sessions[index].requested += delta);
+	const auto wasRequested = dc.totalRequested;
+	dc.totalRequested += delta;
+	if (!wasRequested && dc.totalRequested > 0) {
+		dc.statsActiveSince = crl::now();
+	} else if (wasRequested > 0 && !dc.totalRequested) {
+		dc.statsActive += crl::now() - dc.statsActiveSince;
+	}
+	dc.statsMaxRequested = std::max(dc.statsMaxRequested, dc.totalRequested);
 	const auto findNonEmptySession = [](const DcBalanceData &data) {
 		using namespace rpl::mappers;
 		return ranges::find_if(
@@ -224,7 +258,8 @@ void DownloadManagerMtproto::requestSucceeded(
 		MTP::DcId dcId,
 		int index,
 		int amountAtRequestStart,
-		crl::time timeAtRequestStart) {
+		crl::time timeAtRequestStart,
+		int receivedBytes) {
 	using namespace rpl::mappers;
 
 	const auto guard = gsl::finally([&] {
@@ -236,6 +271,7 @@ void DownloadManagerMtproto::requestSucceeded(
 	auto &dc = i->second;
 	Assert(index < dc.sessions.size());
 	auto &data = dc.sessions[index];
+	countPartLoaded(dcId, dc, index, receivedBytes);
 	const auto overloaded = (timeAtRequestStart <= dc.lastSessionRemove)
 		|| (amountAtRequestStart > data.maxWaitedAmount);
 	const auto parts = amountAtRequestStart / kDownloadPartSize;
@@ -296,6 +332,50 @@ void DownloadManagerMtproto::requestSucceeded(
 		).arg(dc.sessions.size()));
 }
 
+void DownloadManagerMtproto::countPartLoaded(
+		MTP::DcId dcId,
+		DcBalanceData &dc,
+		int index,
+		int bytes) {
+	++dc.sessions[index].statsParts;
+	dc.statsBytes += bytes;
+
+	const auto active = dc.statsActive + (dc.totalRequested > 0
+		? (crl::now() - dc.statsActiveSince)
+		: 0);
+	if (active >= kStatsLogPeriod) {
+		logStats(dcId, dc);
+	}
+}
+
+void DownloadManagerMtproto::logStats(MTP::DcId dcId, DcBalanceData &dc) {
+	const auto now = crl::now();
+	const auto active = dc.statsActive + (dc.totalRequested > 0
+		? (now - dc.statsActiveSince)
+		: 0);
+	auto perSession = QStringList();
+	for (auto &session : dc.sessions) {
+		perSession.push_back(QString::number(session.statsParts));
+		session.statsParts = 0;
+	}
+	if (active > 0) {
+		DEBUG_LOG(("Download Stats: dc %1, %2 KB/s, max in flight %3 KB, "
+			"timeouts %4, parts by session: %5, in removed sessions: %6"
+			).arg(dcId
+			).arg(dc.statsBytes * 1000 / (active * 1024)
+			).arg(dc.statsMaxRequested / 1024
+			).arg(dc.statsTimeouts
+			).arg(perSession.join(',')
+			).arg(dc.statsRemovedSessionsParts));
+	}
+	dc.statsActive = 0;
+	dc.statsActiveSince = now;
+	dc.statsBytes = 0;
+	dc.statsMaxRequested = dc.totalRequested;
+	dc.statsTimeouts = 0;
+	dc.statsRemovedSessionsParts = 0;
+}
+
 int DownloadManagerMtproto::chooseSessionIndex(MTP::DcId dcId) const {
 	const auto i = _balanceData.find(dcId);
 	Assert(i != end(_balanceData));
@@ -317,6 +397,7 @@ void DownloadManagerMtproto::sessionTimedOut(MTP::DcId dcId, int index) {
 		return;
 	}
 	DEBUG_LOG(("Download (%1,%2) session timed-out.").arg(dcId).arg(index));
+	++dc.statsTimeouts;
 	for (auto &session : dc.sessions) {
 		session.successes = 0;
 	}
@@ -346,6 +427,7 @@ void DownloadManagerMtproto::removeSession(MTP::DcId dcId) {
 		dc.sessionRemoveTimes = 1;
 	}
 	auto &session = dc.sessions.back();
+	dc.statsRemovedSessionsParts += base::take(session.statsParts);
 
 	// Make sure we don't send anything to that session while redirecting.
 	session.requested += kMaxWaitedInSession * kMaxSessionsCount;
@@ -398,6 +480,9 @@ void DownloadManagerMtproto::killSessions(MTP::DcId dcId) {
 	if (i != end(_balanceData)) {
 		auto &dc = i->second;
 		Assert(dc.totalRequested == 0);
+		if (dc.statsBytes > 0) {
+			logStats(dcId, dc);
+		}
 		auto sessions = base::take(dc.sessions);
 		dc = DcBalanceData();
 		for (auto j = 0; j != int(sessions.size()); ++j) {
@@ -473,8 +558,14 @@ void DownloadMtprotoTask::refreshFileReferenceFrom(
 	}
 }
 
-void DownloadMtprotoTask::loadPart(int sessionIndex) {
-	makeRequest({ takeNextRequestOffset(), sessionIndex });
+void DownloadMtprotoTask::loadPart(
+		int sessionIndex,
+		int priority,
+		crl::time deadline) {
+	auto requestData = RequestData{ takeNextRequestOffset(), sessionIndex };
+	requestData.priority = priority;
+	requestData.deadline = deadline;
+	makeRequest(requestData);
 }
 
 void DownloadMtprotoTask::removeSession(int sessionIndex) {
@@ -603,12 +694,19 @@ void DownloadMtprotoTask::requestMoreCdnFileHashes() {
 void DownloadMtprotoTask::normalPartLoaded(
 		const MTPupload_File &result,
 		mtpRequestId requestId) {
+	const auto receivedBytes = result.match([](const MTPDupload_file &data) {
+		return int(data.vbytes().v.size());
+	}, [](const MTPDupload_fileCdnRedirect &data) {
+		return 0;
+	});
 	const auto requestData = finishSentRequest(
 		requestId,
-		FinishRequestReason::Success);
+		FinishRequestReason::Success,
+		receivedBytes);
 	result.match([&](const MTPDupload_fileCdnRedirect &data) {
 		switchToCDN(requestData, data);
 	}, [&](const MTPDupload_file &data) {
+		countDeadline(requestData);
 		partLoaded(requestData.offset, data.vbytes().v);
 	});
 }
@@ -619,7 +717,9 @@ void DownloadMtprotoTask::webPartLoaded(
 	result.match([&](const MTPDupload_webFile &data) {
 		const auto requestData = finishSentRequest(
 			requestId,
-			FinishRequestReason::Success);
+			FinishRequestReason::Success,
+			data.vbytes().v.size());
+		countDeadline(requestData);
 		if (setWebFileSizeHook(data.vsize().v)) {
 			partLoaded(requestData.offset, data.vbytes().v);
 		}
@@ -646,7 +746,9 @@ void DownloadMtprotoTask::cdnPartLoaded(const MTPupload_CdnFile &result, mtpRequ
 	}, [&](const MTPDupload_cdnFile &data) {
 		const auto requestData = finishSentRequest(
 			requestId,
-			FinishRequestReason::Success);
+			FinishRequestReason::Success,
+			data.vbytes().v.size());
+		countDeadline(requestData);
 		auto key = bytes::make_span(_cdnEncryptionKey);
 		auto iv = bytes::make_span(_cdnEncryptionIV);
 		Expects(key.size() == MTP::CTRState::KeySize);
@@ -782,7 +884,8 @@ void DownloadMtprotoTask::placeSentRequest(
 
 auto DownloadMtprotoTask::finishSentRequest(
 	mtpRequestId requestId,
-	FinishRequestReason reason)
+	FinishRequestReason reason,
+	int receivedBytes)
 -> RequestData {
 	auto it = _sentRequests.find(requestId);
 	Assert(it != _sentRequests.cend());
@@ -803,7 +906,8 @@ auto DownloadMtprotoTask::finishSentRequest(
 			dcId(),
 			result.sessionIndex,
 			result.requestedInSession,
-			result.sent);
+			result.sent,
+			receivedBytes);
 	}
 
 	Ensures(ok);
@@ -847,14 +951,23 @@ void DownloadMtprotoTask::cancelRequest(mtpRequestId requestId) {
 	}
 }
 
-void DownloadMtprotoTask::addToQueue(int priority) {
-	_owner->enqueue(this, priority);
+void DownloadMtprotoTask::addToQueue(int priority, crl::time deadline) {
+	_owner->enqueue(this, priority, deadline);
 }
 
 void DownloadMtprotoTask::removeFromQueue() {
 	_owner->remove(this);
 }
 
+void DownloadMtprotoTask::countDeadline(const RequestData &requestData) {
+	if (requestData.deadline) {
+		_owner->countDeadline(
+			dcId(),
+			requestData.priority,
+			requestData.deadline);
+	}
+}
+
 void DownloadMtprotoTask::partLoaded(
 		int offset,
 		const QByteArray &bytes) {
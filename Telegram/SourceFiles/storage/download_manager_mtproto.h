@@ -35,7 +35,7 @@ public:
 		return *_api;
 	}
 
-	void enqueue(not_null<Task*> task, int priority);
+	void enqueue(not_null<Task*> task, int priority, crl::time deadline);
 	void remove(not_null<Task*> task);
 
 	void notifyTaskFinished() {
@@ -46,37 +46,56 @@ public:
 	}
 
 	int changeRequestedAmount(MTP::DcId dcId, int index, int delta);
+	void countDeadline(MTP::DcId dcId, int priority, crl::time deadline);
 	void requestSucceeded(
 		MTP::DcId dcId,
 		int index,
 		int amountAtRequestStart,
-		crl::time timeAtRequestStart);
+		crl::time timeAtRequestStart,
+		int receivedBytes);
 	[[nodiscard]] int chooseSessionIndex(MTP::DcId dcId) const;
 
 private:
 	class Queue final {
 	public:
-		void enqueue(not_null<Task*> task, int priority);
+		struct Next {
+			Task *task = nullptr;
+			int priority = 0;
+			crl::time deadline = 0;
+		};
+
+		void enqueue(not_null<Task*> task, int priority, crl::time deadline);
 		void remove(not_null<Task*> task);
 		void resetGeneration();
 		[[nodiscard]] bool empty() const;
-		[[nodiscard]] Task *nextTask(bool onlyHighestPriority) const;
+		[[nodiscard]] Next nextTask(bool onlyHighestPriority) const;
 		void removeSession(int index);
 
 	private:
 		struct Enqueued {
 			not_null<Task*> task;
 			int priority = 0;
+			crl::time deadline = 0;
 		};
+		[[nodiscard]] static bool Before(
+			const Enqueued &a,
+			const Enqueued &b);
+
+		// Sorted by Before(), new tasks go first among equal ones.
 		std::vector<Enqueued> _tasks;
 
 	};
+	struct DeadlineStats {
+		int met = 0;
+		int missed = 0;
+	};
 	struct DcSessionBalanceData {
 		DcSessionBalanceData();
 
 		int requested = 0;
 		int successes = 0; // Since last timeout in this dc in any session.
 		int maxWaitedAmount = 0;
+		int statsParts = 0;
 	};
 	struct DcBalanceData {
 		DcBalanceData();
@@ -87,11 +106,26 @@ private:
 		int sessionRemoveTimes = 0;
 		int timeouts = 0; // Since all sessions had successes >= required.
 		int totalRequested = 0;
+
+		// Throughput statistics for the debug log, counted only for the
+		// time while some parts were in flight.
+		crl::time statsActive = 0;
+		crl::time statsActiveSince = 0;
+		int64 statsBytes = 0;
+		int statsMaxRequested = 0;
+		int statsTimeouts = 0;
+		int statsRemovedSessionsParts = 0;
 	};
 
 	void checkSendNext();
 	void checkSendNext(MTP::DcId dcId, Queue &queue);
 	bool trySendNextPart(MTP::DcId dcId, Queue &queue);
+	void countPartLoaded(
+		MTP::DcId dcId,
+		DcBalanceData &dc,
+		int index,
+		int bytes);
+	void logStats(MTP::DcId dcId, DcBalanceData &dc);
 
 	void killSessionsSchedule(MTP::DcId dcId);
 	void killSessionsCancel(MTP::DcId dcId);
@@ -113,6 +147,7 @@ private:
 	base::Timer _killSessionsTimer;
 
 	base::flat_map<MTP::DcId, Queue> _queues;
+	base::flat_map<int, DeadlineStats> _deadlineStats; // By priority.
 	rpl::lifetime _lifetime;
 
 };
@@ -142,7 +177,7 @@ public:
 	[[nodiscard]] const Location &location() const;
 
 	[[nodiscard]] virtual bool readyToRequest() const = 0;
-	void loadPart(int sessionIndex);
+	void loadPart(int sessionIndex, int priority, crl::time deadline);
 	void removeSession(int sessionIndex);
 
 	void refreshFileReferenceFrom(
@@ -156,7 +191,8 @@ protected:
 	void cancelAllRequests();
 	void cancelRequestForOffset(int offset);
 
-	void addToQueue(int priority = 0);
+	// Deadline is the time the next part is needed by, zero if none.
+	void addToQueue(int priority = 0, crl::time deadline = 0);
 	void removeFromQueue();
 
 	[[nodiscard]] ApiWrap &api() const {
@@ -169,6 +205,8 @@ private:
 		mutable int sessionIndex = 0;
 		int requestedInSession = 0;
 		crl::time sent = 0;
+		int priority = 0;
+		crl::time deadline = 0;
 
 		inline bool operator<(const RequestData &other) const {
 			return offset < other.offset;
@@ -216,6 +254,7 @@ private:
 		const MTPVector<MTPFileHash> &result,
 		mtpRequestId requestId);
 
+	void countDeadline(const RequestData &requestData);
 	void partLoaded(int offset, const QByteArray &bytes);
 
 	bool partFailed(const RPCError &error, mtpRequestId requestId);
@@ -231,7 +270,8 @@ private:
 		const RequestData &requestData);
 	[[nodiscard]] RequestData finishSentRequest(
 		mtpRequestId requestId,
-		FinishRequestReason reason);
+		FinishRequestReason reason,
+		int receivedBytes = 0);
 	void switchToCDN(
 		const RequestData &requestData,
 		const MTPDupload_fileCdnRedirect &redirect);
@@ -196,12 +196,28 @@ void FileLoader::permitLoadFromCloud() {
 	_fromCloud = LoadFromCloudOrLocal;
 }
 
+void FileLoader::resetAutoLoading() {
+	setAutoLoading(false);
+}
+
 void FileLoader::increaseLoadSize(int size, bool autoLoading) {
 	Expects(size > _loadSize);
 	Expects(size <= _fullSize);
 
 	_loadSize = size;
+	setAutoLoading(autoLoading);
+}
+
+void FileLoader::setAutoLoading(bool autoLoading) {
+	if (_autoLoading == autoLoading) {
+		return;
+	}
 	_autoLoading = autoLoading;
+
+	// Re-enqueue an already started loader in the current generation.
+	if (_localStatus != LocalStatus::NotTried && !_finished && !_cancelled) {
+		start();
+	}
 }
 
 void FileLoader::notifyAboutProgress() {
@@ -471,12 +487,47 @@ bool FileLoader::finalizeResult() {
 					_cacheTag));
 		}
 	}
+	if (_decodeImage
+		&& _locationType == UnknownFileLocation
+		&& _imageData.isNull()) {
+		// Decode the image off the main thread before notifying,
+		// so that imageData() doesn't block the main thread later.
+		decodeImageAndNotify();
+		_session->notifyDownloaderTaskFinished();
+		return true;
+	}
 	const auto session = _session;
 	_updates.fire_done();
 	session->notifyDownloaderTaskFinished();
 	return true;
 }
 
+void FileLoader::decodeImageWhenFinished() {
+	_decodeImage = true;
+}
+
+void FileLoader::decodeImageAndNotify() {
+	crl::async([
+		=,
+		data = _data,
+		guard = _imageDecoding.make_guard()
+	]() mutable {
+		auto format = QByteArray();
+		auto image = App::readImage(data, &format, false);
+		crl::on_main(std::move(guard), [
+			=,
+			image = std::move(image),
+			format = std::move(format)
+		]() mutable {
+			if (!image.isNull()) {
+				_imageData = std::move(image);
+				_imageFormat = std::move(format);
+			}
+			_updates.fire_done();
+		});
+	});
+}
+
 std::unique_ptr<FileLoader> CreateFileLoader(
 		not_null<Main::Session*> session,
 		const DownloadLocation &location,
@@ -98,8 +98,14 @@ public:
 
 	bool setFileName(const QString &filename); // set filename for loaders to cache
 	void permitLoadFromCloud();
+
+	// The user asked for the file, load it with the usual priority.
+	void resetAutoLoading();
 	void increaseLoadSize(int size, bool autoLoading);
 
+	// Decode the image on a worker before notifying about the finish.
+	void decodeImageWhenFinished();
+
 	void start();
 	void cancel();
 
@@ -132,6 +138,7 @@ protected:
 	};
 
 	void readImage(int progressiveSizeLimit) const;
+	void setAutoLoading(bool autoLoading);
 
 	bool checkForOpen();
 	bool tryLoadLocal();
@@ -150,11 +157,13 @@ protected:
 
 	bool writeResultPart(int offset, bytes::const_span buffer);
 	bool finalizeResult();
+	void decodeImageAndNotify();
 	[[nodiscard]] QByteArray readLoadedPartBack(int offset, int size);
 
 	const not_null<Main::Session*> _session;
 
 	bool _autoLoading = false;
+	bool _decodeImage = false;
 	uint8 _cacheTag = 0;
 	bool _finished = false;
 	bool _cancelled = false;
@@ -175,6 +184,7 @@ protected:
 	LocationType _locationType = LocationType();
 
 	base::binary_guard _localLoading;
+	base::binary_guard _imageDecoding;
 	mutable QByteArray _imageFormat;
 	mutable QImage _imageData;
 
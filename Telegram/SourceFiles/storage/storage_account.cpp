@@ -17,6 +17,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/serialize_common.h"
 #include "storage/serialize_peer.h"
 #include "storage/serialize_document.h"
+#include "storage/storage_shared_media.h"
 #include "main/main_account.h"
 #include "main/main_session.h"
 #include "mtproto/mtproto_config.h"
@@ -32,6 +33,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "data/data_drafts.h"
 #include "export/export_settings.h"
 #include "window/themes/window_theme.h"
+#include "base/unixtime.h"
 
 namespace Storage {
 namespace {
@@ -40,6 +42,11 @@ using namespace details;
 using Database = Cache::Database;
 
 constexpr auto kDelayedWriteTimeout = crl::time(1000);
+constexpr auto kMaxSharedMediaCountHints = 4096;
+constexpr auto kLocationsJournalMinRecords = 256;
+
+constexpr auto kLocationsJournalSet = quint32(1);
+constexpr auto kLocationsJournalAlias = quint32(2);
 
 constexpr auto kStickersVersionTag = quint32(-1);
 constexpr auto kStickersSerializeVersion = 1;
@@ -76,6 +83,7 @@ enum { // Local Storage Keys
 	lskExportSettings = 0x13, // no data
 	lskBackgroundOld = 0x14, // no data
 	lskSelfSerialized = 0x15, // serialized self
+	lskSharedMediaCounts = 0x16, // no data
 };
 
 [[nodiscard]] FileKey ComputeDataNameKey(const QString &dataName) {
@@ -104,6 +112,29 @@ enum { // Local Storage Keys
 	return cWorkingDir() + qsl("tdata/tdld/");
 }
 
+[[nodiscard]] uint32 LocationSize(const Core::FileLocation &location) {
+	return Serialize::stringSize(location.name())
+		+ Serialize::bytearraySize(location.bookmark())
+		+ Serialize::dateTimeSize()
+		+ sizeof(quint32);
+}
+
+void WriteLocation(QDataStream &stream, const Core::FileLocation &location) {
+	stream
+		<< location.name()
+		<< location.bookmark()
+		<< location.modified
+		<< quint32(location.size);
+}
+
+[[nodiscard]] Core::FileLocation ReadLocation(QDataStream &stream) {
+	auto result = Core::FileLocation();
+	auto bookmark = QByteArray();
+	stream >> result.fname >> bookmark >> result.modified >> result.size;
+	result.setBookmark(bookmark);
+	return result;
+}
+
 } // namespace
 
 Account::Account(not_null<Main::Account*> owner, const QString &dataName)
@@ -118,7 +149,8 @@ Account::Account(not_null<Main::Account*> owner, const QString &dataName)
 , _cacheTotalTimeLimit(Database::Settings().totalTimeLimit)
 , _cacheBigFileTotalTimeLimit(Database::Settings().totalTimeLimit)
 , _writeMapTimer([=] { writeMap(); })
-, _writeLocationsTimer([=] { writeLocations(); }) {
+, _writeLocationsTimer([=] { writeLocations(); })
+, _writeSharedMediaCountsTimer([=] { writeSharedMediaCounts(); }) {
 }
 
 Account::~Account() {
@@ -184,6 +216,7 @@ base::flat_set<QString> Account::collectGoodNames() const {
 		_recentHashtagsAndBotsKey,
 		_exportSettingsKey,
 		_trustedBotsKey,
+		_sharedMediaCountsKey,
 	};
 	auto result = base::flat_set<QString>{
 		"map0",
@@ -211,6 +244,9 @@ base::flat_set<QString> Account::collectGoodNames() const {
 	for (const auto &value : keys) {
 		push(value);
 	}
+	if (_locationsKey) {
+		result.emplace(ToFilePart(_locationsKey) + 'j');
+	}
 	return result;
 }
 
@@ -267,6 +303,7 @@ Account::ReadMapResult Account::readMapWith(
 	quint64 savedGifsKey = 0;
 	quint64 legacyBackgroundKeyDay = 0, legacyBackgroundKeyNight = 0;
 	quint64 userSettingsKey = 0, recentHashtagsAndBotsKey = 0, exportSettingsKey = 0;
+	quint64 sharedMediaCountsKey = 0;
 	while (!map.stream.atEnd()) {
 		quint32 keyType;
 		map.stream >> keyType;
@@ -318,6 +355,9 @@ Account::ReadMapResult Account::readMapWith(
 		case lskTrustedBots: {
 			map.stream >> trustedBotsKey;
 		} break;
+		case lskSharedMediaCounts: {
+			map.stream >> sharedMediaCountsKey;
+		} break;
 		case lskRecentStickersOld: {
 			map.stream >> recentStickersKeyOld;
 		} break;
@@ -375,6 +415,7 @@ Account::ReadMapResult Account::readMapWith(
 
 	_locationsKey = locationsKey;
 	_trustedBotsKey = trustedBotsKey;
+	_sharedMediaCountsKey = sharedMediaCountsKey;
 	_recentStickersKeyOld = recentStickersKeyOld;
 	_installedStickersKey = installedStickersKey;
 	_featuredStickersKey = featuredStickersKey;
@@ -477,6 +518,7 @@ void Account::writeMap() {
 	if (!_draftCursorsMap.empty()) mapSize += sizeof(quint32) * 2 + _draftCursorsMap.size() * sizeof(quint64) * 2;
 	if (_locationsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_trustedBotsKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_sharedMediaCountsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_recentStickersKeyOld) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_installedStickersKey || _featuredStickersKey || _recentStickersKey || _archivedStickersKey) {
 		mapSize += sizeof(quint32) + 4 * sizeof(quint64);
@@ -509,6 +551,9 @@ void Account::writeMap() {
 	if (_trustedBotsKey) {
 		mapData.stream << quint32(lskTrustedBots) << quint64(_trustedBotsKey);
 	}
+	if (_sharedMediaCountsKey) {
+		mapData.stream << quint32(lskSharedMediaCounts) << quint64(_sharedMediaCountsKey);
+	}
 	if (_recentStickersKeyOld) {
 		mapData.stream << quint32(lskRecentStickersOld) << quint64(_recentStickersKeyOld);
 	}
@@ -541,7 +586,7 @@ void Account::reset() {
 	_draftsMap.clear();
 	_draftCursorsMap.clear();
 	_draftsNotReadMap.clear();
-	_locationsKey = _trustedBotsKey = 0;
+	_locationsKey = _trustedBotsKey = _sharedMediaCountsKey = 0;
 	_recentStickersKeyOld = 0;
 	_installedStickersKey = 0;
 	_featuredStickersKey = 0;
@@ -552,9 +597,16 @@ void Account::reset() {
 	_legacyBackgroundKeyDay = _legacyBackgroundKeyNight = 0;
 	_settingsKey = _recentHashtagsAndBotsKey = _exportSettingsKey = 0;
 	_oldMapVersion = 0;
+	_sharedMediaCounts.clear();
+	_sharedMediaCountsRead = false;
+	_writeSharedMediaCountsTimer.cancel();
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
 	_fileLocationAliases.clear();
+	_dirtyLocations.clear();
+	_dirtyLocationAliases.clear();
+	_locationsJournalRecords = 0;
+	_locationsJournalValid = false;
 	_cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
 	_cacheTotalTimeLimit = Database::Settings().totalTimeLimit;
 	_cacheBigFileTotalSizeLimit = Database::Settings().totalSizeLimit;
@@ -586,64 +638,291 @@ void Account::writeLocations() {
 
 	if (_fileLocations.isEmpty()) {
 		if (_locationsKey) {
+			clearLocationsJournal();
 			ClearKey(_locationsKey, _basePath);
 			_locationsKey = 0;
 			writeMapDelayed();
 		}
-	} else {
-		if (!_locationsKey) {
-			_locationsKey = GenerateKey(_basePath);
-			writeMapQueued();
-		}
-		quint32 size = 0;
-		for (auto i = _fileLocations.cbegin(), e = _fileLocations.cend(); i != e; ++i) {
-			// location + type + namelen + name
-			size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(i.value().name());
-			if (AppVersion > 9013) {
-				// bookmark
-				size += Serialize::bytearraySize(i.value().bookmark());
-			}
-			// date + size
-			size += Serialize::dateTimeSize() + sizeof(quint32);
-		}
+	} else if (!appendLocationsJournal()) {
+		writeLocationsSnapshot();
+	}
+	_dirtyLocations.clear();
+	_dirtyLocationAliases.clear();
+}
 
-		//end mark
-		size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(QString());
+void Account::writeLocationsSnapshot() {
+	Expects(!_fileLocations.isEmpty());
+
+	if (!_locationsKey) {
+		_locationsKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	quint32 size = 0;
+	for (auto i = _fileLocations.cbegin(), e = _fileLocations.cend(); i != e; ++i) {
+		// location + type + namelen + name
+		size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(i.value().name());
 		if (AppVersion > 9013) {
-			size += Serialize::bytearraySize(QByteArray());
+			// bookmark
+			size += Serialize::bytearraySize(i.value().bookmark());
 		}
+		// date + size
 		size += Serialize::dateTimeSize() + sizeof(quint32);
+	}
 
-		size += sizeof(quint32); // aliases count
-		for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
-			// alias + location
-			size += sizeof(quint64) * 2 + sizeof(quint64) * 2;
-		}
+	//end mark
+	size += sizeof(quint64) * 2 + sizeof(quint32) + Serialize::stringSize(QString());
+	if (AppVersion > 9013) {
+		size += Serialize::bytearraySize(QByteArray());
+	}
+	size += Serialize::dateTimeSize() + sizeof(quint32);
 
-		EncryptedDescriptor data(size);
-		auto legacyTypeField = 0;
-		for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
-			data.stream << quint64(i.key().first) << quint64(i.key().second) << quint32(legacyTypeField) << i.value().name();
-			if (AppVersion > 9013) {
-				data.stream << i.value().bookmark();
-			}
-			data.stream << i.value().modified << quint32(i.value().size);
-		}
+	size += sizeof(quint32); // aliases count
+	for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
+		// alias + location
+		size += sizeof(quint64) * 2 + sizeof(quint64) * 2;
+	}
+	size += sizeof(quint32); // legacy web locations count
+	size += sizeof(quint64); // journal generation
 
-		data.stream << quint64(0) << quint64(0) << quint32(0) << QString();
+	EncryptedDescriptor data(size);
+	auto legacyTypeField = 0;
+	for (auto i = _fileLocations.cbegin(); i != _fileLocations.cend(); ++i) {
+		data.stream << quint64(i.key().first) << quint64(i.key().second) << quint32(legacyTypeField) << i.value().name();
 		if (AppVersion > 9013) {
-			data.stream << QByteArray();
+			data.stream << i.value().bookmark();
 		}
-		data.stream << QDateTime::currentDateTime() << quint32(0);
+		data.stream << i.value().modified << quint32(i.value().size);
+	}
 
-		data.stream << quint32(_fileLocationAliases.size());
-		for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
-			data.stream << quint64(i.key().first) << quint64(i.key().second) << quint64(i.value().first) << quint64(i.value().second);
-		}
+	data.stream << quint64(0) << quint64(0) << quint32(0) << QString();
+	if (AppVersion > 9013) {
+		data.stream << QByteArray();
+	}
+	data.stream << QDateTime::currentDateTime() << quint32(0);
+
+	data.stream << quint32(_fileLocationAliases.size());
+	for (auto i = _fileLocationAliases.cbegin(), e = _fileLocationAliases.cend(); i != e; ++i) {
+		data.stream << quint64(i.key().first) << quint64(i.key().second) << quint64(i.value().first) << quint64(i.value().second);
+	}
 
+	// Identifies the snapshot the journal applies to.
+	const auto generation = rand_value<uint64>();
+	data.stream << quint32(0) << quint64(generation);
+
+	{
 		FileWriteDescriptor file(_locationsKey, _basePath);
 		file.writeEncrypted(data, _localKey);
 	}
+
+	startLocationsJournal(generation);
+}
+
+QString Account::locationsJournalPath() const {
+	Expects(_locationsKey != 0);
+
+	return _basePath + ToFilePart(_locationsKey) + 'j';
+}
+
+void Account::startLocationsJournal(uint64 generation) {
+	_locationsJournalRecords = 0;
+	_locationsJournalValid = false;
+
+	QFile file(locationsJournalPath());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		LOG(("Storage Error: Could not start locations journal."));
+		return;
+	}
+	EncryptedDescriptor header(sizeof(quint64));
+	header.stream << quint64(generation);
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << PrepareEncrypted(header, _localKey);
+	_locationsJournalValid = (stream.status() == QDataStream::Ok);
+}
+
+void Account::clearLocationsJournal() {
+	QFile::remove(locationsJournalPath());
+	_locationsJournalRecords = 0;
+	_locationsJournalValid = false;
+}
+
+bool Account::appendLocationsJournal() {
+	const auto records = int(_dirtyLocations.size()
+		+ _dirtyLocationAliases.size());
+	const auto limit = std::max(
+		kLocationsJournalMinRecords,
+		int(_fileLocations.size()));
+	if (!_locationsKey
+		|| !_locationsJournalValid
+		|| !records
+		|| _locationsJournalRecords + records > limit) {
+		return false;
+	}
+
+	auto size = uint32(sizeof(quint32));
+	for (const auto &location : _dirtyLocations) {
+		size += sizeof(quint32) + sizeof(quint64) * 2 + sizeof(quint32);
+		for (auto i = _fileLocations.constFind(location)
+			; (i != _fileLocations.cend()) && (i.key() == location)
+			; ++i) {
+			size += LocationSize(i.value());
+		}
+	}
+	size += _dirtyLocationAliases.size()
+		* (sizeof(quint32) + sizeof(quint64) * 4);
+
+	EncryptedDescriptor data(size);
+	data.stream << quint32(records);
+	for (const auto &location : _dirtyLocations) {
+		data.stream
+			<< kLocationsJournalSet
+			<< quint64(location.first)
+			<< quint64(location.second)
+			<< quint32(_fileLocations.count(location));
+		for (auto i = _fileLocations.constFind(location)
+			; (i != _fileLocations.cend()) && (i.key() == location)
+			; ++i) {
+			WriteLocation(data.stream, i.value());
+		}
+	}
+	for (const auto &[alias, location] : _dirtyLocationAliases) {
+		data.stream
+			<< kLocationsJournalAlias
+			<< quint64(alias.first)
+			<< quint64(alias.second)
+			<< quint64(location.first)
+			<< quint64(location.second);
+	}
+
+	QFile file(locationsJournalPath());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		LOG(("Storage Error: Could not append to locations journal."));
+		return false;
+	}
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << PrepareEncrypted(data, _localKey);
+	if (stream.status() != QDataStream::Ok) {
+		LOG(("Storage Error: Could not append to locations journal."));
+		return false;
+	}
+	_locationsJournalRecords += records;
+	return true;
+}
+
+void Account::readLocationsJournal(uint64 generation) {
+	QFile file(locationsJournalPath());
+	if (!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+
+	auto encrypted = QByteArray();
+	stream >> encrypted;
+
+	EncryptedDescriptor header;
+	if (!CheckStreamStatus(stream)
+		|| !DecryptLocal(header, encrypted, _localKey)) {
+		return;
+	}
+	auto journalGeneration = quint64();
+	header.stream >> journalGeneration;
+	if (!CheckStreamStatus(header.stream)
+		|| journalGeneration != generation) {
+		LOG(("Storage Error: Locations journal generation mismatch, "
+			"expected %1, got %2. Skipping the journal."
+			).arg(generation
+			).arg(journalGeneration));
+		return;
+	}
+
+	const auto set = [&](
+			MediaKey location,
+			std::vector<Core::FileLocation> &&values) {
+		for (auto i = _fileLocations.find(location)
+			; (i != _fileLocations.end()) && (i.key() == location);) {
+			if (!i.value().inMediaCache()) {
+				const auto j = _fileLocationPairs.find(i.value().fname);
+				if (j != _fileLocationPairs.end()
+					&& j.value().first == location) {
+					_fileLocationPairs.erase(j);
+				}
+			}
+			i = _fileLocations.erase(i);
+		}
+		for (auto &value : values) {
+			if (!value.inMediaCache()) {
+				_fileLocationPairs.insert(value.fname, { location, value });
+			}
+			_fileLocations.insert(location, std::move(value));
+		}
+	};
+	auto records = 0;
+	auto damaged = false;
+	while (!stream.atEnd()) {
+		stream >> encrypted;
+
+		EncryptedDescriptor data;
+		if (!CheckStreamStatus(stream)
+			|| !DecryptLocal(data, encrypted, _localKey)) {
+			damaged = true;
+			break;
+		}
+		auto count = quint32();
+		data.stream >> count;
+		for (auto i = quint32(); i != count; ++i) {
+			auto type = quint32();
+			auto first = quint64();
+			auto second = quint64();
+			data.stream >> type >> first >> second;
+			if (type == kLocationsJournalSet) {
+				auto valuesCount = quint32();
+				data.stream >> valuesCount;
+				auto values = std::vector<Core::FileLocation>();
+				for (auto j = quint32(); j != valuesCount; ++j) {
+					values.push_back(ReadLocation(data.stream));
+				}
+				if (!CheckStreamStatus(data.stream)) {
+					damaged = true;
+					break;
+				}
+				set(MediaKey(first, second), std::move(values));
+			} else if (type == kLocationsJournalAlias) {
+				auto toFirst = quint64();
+				auto toSecond = quint64();
+				data.stream >> toFirst >> toSecond;
+				if (!CheckStreamStatus(data.stream)) {
+					damaged = true;
+					break;
+				}
+				_fileLocationAliases.insert(
+					MediaKey(first, second),
+					MediaKey(toFirst, toSecond));
+			} else {
+				damaged = true;
+				break;
+			}
+			++records;
+		}
+		if (damaged) {
+			break;
+		}
+	}
+	_locationsJournalRecords = records;
+	_locationsJournalValid = !damaged;
+	if (damaged) {
+		LOG(("Storage Error: Damaged locations journal, rewriting."));
+		writeLocationsDelayed();
+	} else {
+		DEBUG_LOG(("Storage Info: Replayed %1 locations journal records."
+			).arg(records));
+	}
+}
+
+void Account::locationsChangedFor(MediaKey location) {
+	_dirtyLocations.emplace(location);
 }
 
 void Account::writeLocationsQueued() {
@@ -661,6 +940,7 @@ void Account::writeLocationsDelayed() {
 void Account::readLocations() {
 	FileReadDescriptor locations;
 	if (!ReadEncryptedFile(locations, _locationsKey, _basePath, _localKey)) {
+		clearLocationsJournal();
 		ClearKey(_locationsKey, _basePath);
 		_locationsKey = 0;
 		writeMapDelayed();
@@ -713,6 +993,11 @@ void Account::readLocations() {
 				ClearKey(key, _basePath);
 			}
 		}
+		auto generation = quint64();
+		if (!locations.stream.atEnd()) {
+			locations.stream >> generation;
+		}
+		readLocationsJournal(generation);
 	}
 }
 
@@ -1362,6 +1647,9 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 			if (i.value().second == local) {
 				if (i.value().first != location) {
 					_fileLocationAliases.insert(location, i.value().first);
+					_dirtyLocationAliases.emplace_back(
+						location,
+						i.value().first);
 					writeLocationsQueued();
 				}
 				return;
@@ -1370,6 +1658,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 				for (auto j = _fileLocations.find(i.value().first), e = _fileLocations.end(); (j != e) && (j.key() == i.value().first); ++j) {
 					if (j.value() == i.value().second) {
 						_fileLocations.erase(j);
+						locationsChangedFor(i.value().first);
 						break;
 					}
 				}
@@ -1386,6 +1675,7 @@ void Account::writeFileLocation(MediaKey location, const Core::FileLocation &loc
 		}
 	}
 	_fileLocations.insert(location, local);
+	locationsChangedFor(location);
 	writeLocationsQueued();
 }
 
@@ -1397,6 +1687,7 @@ void Account::removeFileLocation(MediaKey location) {
 	while (i != _fileLocations.end() && (i.key() == location)) {
 		i = _fileLocations.erase(i);
 	}
+	locationsChangedFor(location);
 	writeLocationsQueued();
 }
 
@@ -1410,6 +1701,7 @@ Core::FileLocation Account::readFileLocation(MediaKey location) {
 		if (!i.value().inMediaCache() && !i.value().check()) {
 			_fileLocationPairs.remove(i.value().fname);
 			i = _fileLocations.erase(i);
+			locationsChangedFor(location);
 			writeLocationsDelayed();
 			continue;
 		}
@@ -1624,7 +1916,7 @@ void Account::readStickerSets(
 		Data::StickersSetsOrder *outOrder,
 		MTPDstickerSet::Flags readingFlags) {
 	FileReadDescriptor stickers;
-	if (!ReadEncryptedFile(stickers, stickersKey, _basePath, _localKey)) {
+	if (!readEncryptedFile(stickers, stickersKey)) {
 		ClearKey(stickersKey, _basePath);
 		stickersKey = 0;
 		writeMapDelayed();
@@ -2115,7 +2407,7 @@ void Account::readSavedGifs() {
 	if (!_savedGifsKey) return;
 
 	FileReadDescriptor gifs;
-	if (!ReadEncryptedFile(gifs, _savedGifsKey, _basePath, _localKey)) {
+	if (!readEncryptedFile(gifs, _savedGifsKey)) {
 		ClearKey(_savedGifsKey, _basePath);
 		_savedGifsKey = 0;
 		writeMapDelayed();
@@ -2152,6 +2444,60 @@ void Account::readSavedGifs() {
 	}
 }
 
+void Account::prefetchStickersAndGifs() {
+	const auto started = crl::now();
+	const auto keys = std::array<FileKey, 5>{ {
+		_installedStickersKey,
+		_featuredStickersKey,
+		_recentStickersKey,
+		_favedStickersKey,
+		_savedGifsKey,
+	} };
+	auto results = std::array<std::unique_ptr<DecryptedFile>, 5>();
+	auto semaphore = crl::semaphore();
+	auto waiting = 0;
+	for (auto i = 0; i != int(keys.size()); ++i) {
+		if (!keys[i]) {
+			continue;
+		}
+		++waiting;
+		crl::async([&, i] {
+			if (auto file = ReadDecryptedFile(
+					ToFilePart(keys[i]),
+					_basePath,
+					_localKey)) {
+				results[i] = std::make_unique<DecryptedFile>(
+					std::move(*file));
+			}
+			semaphore.release();
+		});
+	}
+	for (auto i = 0; i != waiting; ++i) {
+		semaphore.acquire();
+	}
+	for (auto i = 0; i != int(keys.size()); ++i) {
+		if (keys[i]) {
+			_prefetchedFiles.emplace(keys[i], std::move(results[i]));
+		}
+	}
+	LOG(("App Info: stickers and gifs files prefetched in %1 ms."
+		).arg(crl::now() - started));
+}
+
+bool Account::readEncryptedFile(FileReadDescriptor &result, FileKey key) {
+	const auto i = _prefetchedFiles.find(key);
+	if (i == end(_prefetchedFiles)) {
+		return ReadEncryptedFile(result, key, _basePath, _localKey);
+	}
+	const auto file = std::move(i->second);
+	_prefetchedFiles.erase(i);
+	if (!file) {
+		return false;
+	}
+	OpenDecryptedFile(result, std::move(*file));
+	return true;
+}
+
 void Account::writeRecentHashtagsAndBots() {
 	const auto &write = cRecentWriteHashtags();
 	const auto &search = cRecentSearchHashtags();
@@ -2542,6 +2888,123 @@ bool Account::isBotTrusted(not_null<UserData*> bot) {
 	return _trustedBots.contains(bot->id);
 }
 
+void Account::writeSharedMediaCounts() {
+	_writeSharedMediaCountsTimer.cancel();
+	if (_sharedMediaCounts.empty()) {
+		if (_sharedMediaCountsKey) {
+			ClearKey(_sharedMediaCountsKey, _basePath);
+			_sharedMediaCountsKey = 0;
+			writeMapDelayed();
+		}
+		return;
+	}
+	if (!_sharedMediaCountsKey) {
+		_sharedMediaCountsKey = GenerateKey(_basePath);
+		writeMapQueued();
+	}
+	quint32 size = sizeof(qint32) + _sharedMediaCounts.size()
+		* (sizeof(quint64) + sizeof(qint32) * 3);
+	EncryptedDescriptor data(size);
+	data.stream << qint32(_sharedMediaCounts.size());
+	for (const auto &[key, hint] : _sharedMediaCounts) {
+		data.stream
+			<< quint64(key.first)
+			<< qint32(key.second)
+			<< qint32(hint.count)
+			<< qint32(hint.updated);
+	}
+
+	FileWriteDescriptor file(_sharedMediaCountsKey, _basePath);
+	file.writeEncrypted(data, _localKey);
+}
+
+void Account::readSharedMediaCounts() {
+	if (!_sharedMediaCountsKey) return;
+
+	FileReadDescriptor counts;
+	if (!ReadEncryptedFile(counts, _sharedMediaCountsKey, _basePath, _localKey)) {
+		ClearKey(_sharedMediaCountsKey, _basePath);
+		_sharedMediaCountsKey = 0;
+		writeMapDelayed();
+		return;
+	}
+
+	qint32 size = 0;
+	counts.stream >> size;
+	for (auto i = 0; i < size; ++i) {
+		quint64 peerId = 0;
+		qint32 type = 0, count = 0, updated = 0;
+		counts.stream >> peerId >> type >> count >> updated;
+		if (counts.stream.status() != QDataStream::Ok) {
+			break;
+		}
+		const auto mediaType = SharedMediaType(type);
+		if (IsValidSharedMediaType(mediaType) && count >= 0) {
+			_sharedMediaCounts.emplace(
+				std::make_pair(PeerId(peerId), mediaType),
+				SharedMediaCountHint{ count, updated });
+		}
+	}
+}
+
+std::optional<int> Account::sharedMediaCountHint(
+		PeerId peerId,
+		SharedMediaType type) {
+	if (!_sharedMediaCountsRead) {
+		readSharedMediaCounts();
+		_sharedMediaCountsRead = true;
+	}
+	const auto i = _sharedMediaCounts.find(std::make_pair(peerId, type));
+	return (i != end(_sharedMediaCounts))
+		? std::make_optional(i->second.count)
+		: std::nullopt;
+}
+
+void Account::setSharedMediaCountHint(
+		PeerId peerId,
+		SharedMediaType type,
+		int count) {
+	const auto was = sharedMediaCountHint(peerId, type);
+	const auto key = std::make_pair(peerId, type);
+	const auto now = base::unixtime::now();
+	if (was == count) {
+		// Saved with the next changed count, no need to write it now.
+		_sharedMediaCounts[key].updated = now;
+		return;
+	} else if (!was
+		&& _sharedMediaCounts.size() >= kMaxSharedMediaCountHints) {
+		trimSharedMediaCounts();
+	}
+	_sharedMediaCounts[key] = SharedMediaCountHint{ count, now };
+	if (!_writeSharedMediaCountsTimer.isActive()) {
+		_writeSharedMediaCountsTimer.callOnce(kDelayedWriteTimeout);
+	}
+}
+
+void Account::trimSharedMediaCounts() {
+	// Forget the least recently updated quarter of the hints at once.
+	auto updated = ranges::view::all(
+		_sharedMediaCounts
+	) | ranges::view::transform([](const auto &pair) {
+		return pair.second.updated;
+	}) | ranges::to_vector;
+	const auto forget = int(updated.size()) / 4;
+	if (!forget) {
+		return;
+	}
+	ranges::nth_element(updated, begin(updated) + forget - 1);
+	const auto threshold = updated[forget - 1];
+	auto removed = 0;
+	for (auto i = begin(_sharedMediaCounts); i != end(_sharedMediaCounts);) {
+		if (removed < forget && i->second.updated <= threshold) {
+			i = _sharedMediaCounts.erase(i);
+			++removed;
+		} else {
+			++i;
+		}
+	}
+}
+
 bool Account::encrypt(
 		const void *src,
 		void *dst,
@@ -38,9 +38,13 @@ using AuthKeyPtr = std::shared_ptr<AuthKey>;
 } // namespace MTP
 
 namespace Storage {
+
+enum class SharedMediaType : signed char;
+
 namespace details {
 struct ReadSettingsContext;
 struct FileReadDescriptor;
+struct DecryptedFile;
 } // namespace details
 
 class EncryptionKey;
@@ -118,6 +122,10 @@ public:
 	void writeSavedGifs();
 	void readSavedGifs();
 
+	// Reads and decrypts sticker sets and saved gifs in parallel,
+	// so that the following read*() calls only parse the data.
+	void prefetchStickersAndGifs();
+
 	void writeRecentHashtagsAndBots();
 	void readRecentHashtagsAndBots();
 	void saveRecentSentHashtags(const QString &text);
@@ -138,6 +146,16 @@ public:
 	void markBotTrusted(not_null<UserData*> bot);
 	[[nodiscard]] bool isBotTrusted(not_null<UserData*> bot);
 
+	// Shared media counts from the last session, shown until the actual
+	// counts are received from the server.
+	[[nodiscard]] std::optional<int> sharedMediaCountHint(
+		PeerId peerId,
+		SharedMediaType type);
+	void setSharedMediaCountHint(
+		PeerId peerId,
+		SharedMediaType type,
+		int count);
+
 	[[nodiscard]] bool encrypt(
 		const void *src,
 		void *dst,
@@ -174,6 +192,13 @@ private:
 	void writeLocations();
 	void writeLocationsQueued();
 	void writeLocationsDelayed();
+	void writeLocationsSnapshot();
+	[[nodiscard]] QString locationsJournalPath() const;
+	void readLocationsJournal(uint64 generation);
+	[[nodiscard]] bool appendLocationsJournal();
+	void startLocationsJournal(uint64 generation);
+	void clearLocationsJournal();
+	void locationsChangedFor(MediaKey location);
 
 	std::unique_ptr<Main::SessionSettings> readSessionSettings();
 	void writeSessionSettings(Main::SessionSettings *stored);
@@ -212,6 +237,14 @@ private:
 	void readTrustedBots();
 	void writeTrustedBots();
 
+	void readSharedMediaCounts();
+	void writeSharedMediaCounts();
+	void trimSharedMediaCounts();
+
+	bool readEncryptedFile(
+		details::FileReadDescriptor &result,
+		FileKey key);
+
 	std::optional<RecentHashtagPack> saveRecentHashtags(
 		Fn<RecentHashtagPack()> getPack,
 		const QString &text);
@@ -225,6 +258,11 @@ private:
 
 	MTP::AuthKeyPtr _localKey;
 
+	// Null pointer means that the prefetched file could not be read.
+	base::flat_map<
+		FileKey,
+		std::unique_ptr<details::DecryptedFile>> _prefetchedFiles;
+
 	base::flat_map<PeerId, FileKey> _draftsMap;
 	base::flat_map<PeerId, FileKey> _draftCursorsMap;
 	base::flat_map<PeerId, bool> _draftsNotReadMap;
@@ -233,6 +271,12 @@ private:
 	QMap<QString, QPair<MediaKey, Core::FileLocation>> _fileLocationPairs;
 	QMap<MediaKey, MediaKey> _fileLocationAliases;
 
+	// Changes since the last full locations write, appended to the journal.
+	base::flat_set<MediaKey> _dirtyLocations;
+	std::vector<std::pair<MediaKey, MediaKey>> _dirtyLocationAliases;
+	int _locationsJournalRecords = 0;
+	bool _locationsJournalValid = false;
+
 	FileKey _locationsKey = 0;
 	FileKey _trustedBotsKey = 0;
 	FileKey _installedStickersKey = 0;
@@ -247,6 +291,7 @@ private:
 	FileKey _settingsKey = 0;
 	FileKey _recentHashtagsAndBotsKey = 0;
 	FileKey _exportSettingsKey = 0;
+	FileKey _sharedMediaCountsKey = 0;
 
 	qint64 _cacheTotalSizeLimit = 0;
 	qint64 _cacheBigFileTotalSizeLimit = 0;
@@ -255,6 +300,15 @@ private:
 
 	base::flat_set<uint64> _trustedBots;
 	bool _trustedBotsRead = false;
+
+	struct SharedMediaCountHint {
+		int count = 0;
+		TimeId updated = 0;
+	};
+	base::flat_map<
+		std::pair<PeerId, SharedMediaType>,
+		SharedMediaCountHint> _sharedMediaCounts;
+	bool _sharedMediaCountsRead = false;
 	bool _readingUserSettings = false;
 	bool _recentHashtagsAndBotsWereRead = false;
 
@@ -262,6 +316,7 @@ private:
 
 	base::Timer _writeMapTimer;
 	base::Timer _writeLocationsTimer;
+	base::Timer _writeSharedMediaCountsTimer;
 	bool _mapChanged = false;
 	bool _locationsChanged = false;
 
@@ -17,6 +17,35 @@ using namespace Images;
 namespace Images {
 namespace {
 
+struct PixmapCacheState {
+	std::unordered_set<const Image*> images;
+	int64 bytes = 0;
+	uint64 tick = 0;
+	int64 hits = 0;
+	int64 misses = 0;
+	int64 evicted = 0;
+	bool trimScheduled = false;
+};
+
+// Not a function-local static, so that it outlives Image::Empty().
+PixmapCacheState PixmapCache;
+
+[[nodiscard]] PixmapCacheState &CacheState() {
+	return PixmapCache;
+}
+
+// All scaled pixmaps of all images share this memory budget,
+// it can be changed by the "-pixmapcache <megabytes>" launch option.
+[[nodiscard]] int64 PixmapCacheLimit() {
+	return int64(cPixmapCacheMegabytes()) * 1024 * 1024;
+}
+
+[[nodiscard]] int64 PixmapBytes(const QPixmap &pixmap) {
+	return int64(pixmap.width())
+		* pixmap.height()
+		* std::max(pixmap.depth() / 8, 1);
+}
+
 [[nodiscard]] uint64 PixKey(int width, int height, Options options) {
 	return static_cast<uint64>(width)
 		| (static_cast<uint64>(height) << 24)
@@ -144,10 +173,111 @@ not_null<Image*> Image::BlankMedia() {
 	return &result;
 }
 
+Image::~Image() {
+	clearCache();
+}
+
 QImage Image::original() const {
 	return _data;
 }
 
+template <typename Generate>
+const QPixmap &Image::cached(
+		uint64 key,
+		QSize size,
+		Generate &&generate) const {
+	auto &state = CacheState();
+	auto i = _cache.find(key);
+	const auto good = (i != _cache.end())
+		&& (size.isEmpty() || i->second.pixmap.size() == size);
+	if (good) {
+		++state.hits;
+		i->second.lastUsed = ++state.tick;
+		return i->second.pixmap;
+	}
+	++state.misses;
+	if (i != _cache.end()) {
+		state.bytes -= PixmapBytes(i->second.pixmap);
+	} else if (_cache.empty()) {
+		state.images.emplace(this);
+	}
+	auto pixmap = generate();
+	pixmap.setDevicePixelRatio(cRetinaFactor());
+	state.bytes += PixmapBytes(pixmap);
+	i = _cache.emplace_or_assign(
+		key,
+		CachedPixmap{ std::move(pixmap), ++state.tick }).first;
+	if (state.bytes > PixmapCacheLimit() && !state.trimScheduled) {
+		// Callers may still hold references to other cached pixmaps,
+		// so we evict only after the current event is processed.
+		state.trimScheduled = true;
+		crl::on_main([] { TrimCache(); });
+	}
+	return i->second.pixmap;
+}
+
+void Image::removeCached(uint64 key) const {
+	const auto i = _cache.find(key);
+	if (i == _cache.end()) {
+		return;
+	}
+	auto &state = CacheState();
+	state.bytes -= PixmapBytes(i->second.pixmap);
+	_cache.erase(i);
+	if (_cache.empty()) {
+		state.images.erase(this);
+	}
+}
+
+void Image::clearCache() const {
+	if (_cache.empty()) {
+		return;
+	}
+	auto &state = CacheState();
+	for (const auto &[key, entry] : _cache) {
+		state.bytes -= PixmapBytes(entry.pixmap);
+	}
+	_cache.clear();
+	state.images.erase(this);
+}
+
+void Image::TrimCache() {
+	auto &state = CacheState();
+	state.trimScheduled = false;
+	if (state.bytes <= PixmapCacheLimit()) {
+		return;
+	}
+	struct Candidate {
+		uint64 lastUsed = 0;
+		const Image *image = nullptr;
+		uint64 key = 0;
+	};
+	auto candidates = std::vector<Candidate>();
+	for (const auto image : state.images) {
+		for (const auto &[key, entry] : image->_cache) {
+			candidates.push_back({ entry.lastUsed, image, key });
+		}
+	}
+	ranges::sort(candidates, ranges::less(), &Candidate::lastUsed);
+
+	const auto trimTo = PixmapCacheLimit() * 3 / 4;
+	const auto was = state.bytes;
+	for (const auto &candidate : candidates) {
+		if (state.bytes <= trimTo) {
+			break;
+		}
+		candidate.image->removeCached(candidate.key);
+		++state.evicted;
+	}
+	DEBUG_LOG(("Image Info: pixmap cache trimmed %1 -> %2 bytes, "
+		"hits: %3, misses: %4, evicted: %5."
+		).arg(was
+		).arg(state.bytes
+		).arg(state.hits
+		).arg(state.misses
+		).arg(state.evicted));
+}
+
 const QPixmap &Image::pix(int w, int h) const {
 	if (w <= 0 || !width() || !height()) {
 		w = width();
@@ -156,14 +286,9 @@ const QPixmap &Image::pix(int w, int h) const {
 		h *= cIntRetinaFactor();
 	}
 	auto options = Option::Smooth | Option::None;
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixNoCache(w, h, options);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixNoCache(w, h, options);
+	});
 }
 
 const QPixmap &Image::pixRounded(
@@ -191,14 +316,9 @@ const QPixmap &Image::pixRounded(
 	} else if (radius == ImageRoundRadius::Ellipse) {
 		options |= Option::Circled | cornerOptions(corners);
 	}
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixNoCache(w, h, options);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixNoCache(w, h, options);
+	});
 }
 
 const QPixmap &Image::pixCircled(int w, int h) const {
@@ -209,14 +329,9 @@ const QPixmap &Image::pixCircled(int w, int h) const {
 		h *= cIntRetinaFactor();
 	}
 	auto options = Option::Smooth | Option::Circled;
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixNoCache(w, h, options);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixNoCache(w, h, options);
+	});
 }
 
 const QPixmap &Image::pixBlurredCircled(int w, int h) const {
@@ -227,14 +342,9 @@ const QPixmap &Image::pixBlurredCircled(int w, int h) const {
 		h *= cIntRetinaFactor();
 	}
 	auto options = Option::Smooth | Option::Circled | Option::Blurred;
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixNoCache(w, h, options);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixNoCache(w, h, options);
+	});
 }
 
 const QPixmap &Image::pixBlurred(int w, int h) const {
@@ -245,14 +355,9 @@ const QPixmap &Image::pixBlurred(int w, int h) const {
 		h *= cIntRetinaFactor();
 	}
 	auto options = Option::Smooth | Option::Blurred;
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixNoCache(w, h, options);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixNoCache(w, h, options);
+	});
 }
 
 const QPixmap &Image::pixColored(style::color add, int w, int h) const {
@@ -263,14 +368,9 @@ const QPixmap &Image::pixColored(style::color add, int w, int h) const {
 		h *= cIntRetinaFactor();
 	}
 	auto options = Option::Smooth | Option::Colored;
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixColoredNoCache(add, w, h, true);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixColoredNoCache(add, w, h, true);
+	});
 }
 
 const QPixmap &Image::pixBlurredColored(
@@ -284,14 +384,9 @@ const QPixmap &Image::pixBlurredColored(
 		h *= cIntRetinaFactor();
 	}
 	auto options = Option::Blurred | Option::Smooth | Option::Colored;
-	auto k = PixKey(w, h, options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend()) {
-		auto p = pixBlurredColoredNoCache(add, w, h);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	return cached(PixKey(w, h, options), QSize(), [&] {
+		return pixBlurredColoredNoCache(add, w, h);
+	});
 }
 
 const QPixmap &Image::pixSingle(
@@ -327,14 +422,10 @@ const QPixmap &Image::pixSingle(
 		options |= Option::Colored;
 	}
 
-	auto k = SinglePixKey(options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend() || i->second.width() != (outerw * cIntRetinaFactor()) || i->second.height() != (outerh * cIntRetinaFactor())) {
-		auto p = pixNoCache(w, h, options, outerw, outerh, colored);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	const auto size = QSize(outerw, outerh) * cIntRetinaFactor();
+	return cached(SinglePixKey(options), size, [&] {
+		return pixNoCache(w, h, options, outerw, outerh, colored);
+	});
 }
 
 const QPixmap &Image::pixBlurredSingle(
@@ -366,14 +457,10 @@ const QPixmap &Image::pixBlurredSingle(
 		options |= Option::Circled | cornerOptions(corners);
 	}
 
-	auto k = SinglePixKey(options);
-	auto i = _cache.find(k);
-	if (i == _cache.cend() || i->second.width() != (outerw * cIntRetinaFactor()) || i->second.height() != (outerh * cIntRetinaFactor())) {
-		auto p = pixNoCache(w, h, options, outerw, outerh);
-		p.setDevicePixelRatio(cRetinaFactor());
-		i = _cache.emplace_or_assign(k, p).first;
-	}
-	return i->second;
+	const auto size = QSize(outerw, outerh) * cIntRetinaFactor();
+	return cached(SinglePixKey(options), size, [&] {
+		return pixNoCache(w, h, options, outerw, outerh);
+	});
 }
 
 QPixmap Image::pixNoCache(
@@ -24,6 +24,9 @@ public:
 	explicit Image(const QString &path);
 	explicit Image(const QByteArray &content);
 	explicit Image(QImage &&data);
+	Image(const Image &other) = delete;
+	Image &operator=(const Image &other) = delete;
+	~Image();
 
 	[[nodiscard]] static not_null<Image*> Empty(); // 1x1 transparent
 	[[nodiscard]] static not_null<Image*> BlankMedia(); // 1x1 black
@@ -91,7 +94,21 @@ public:
 		int h = 0) const;
 
 private:
+	struct CachedPixmap {
+		QPixmap pixmap;
+		uint64 lastUsed = 0;
+	};
+
+	template <typename Generate>
+	[[nodiscard]] const QPixmap &cached(
+		uint64 key,
+		QSize size,
+		Generate &&generate) const;
+	void removeCached(uint64 key) const;
+	void clearCache() const;
+	static void TrimCache();
+
 	const QImage _data;
-	mutable base::flat_map<uint64, QPixmap> _cache;
+	mutable base::flat_map<uint64, CachedPixmap> _cache;
 
 };
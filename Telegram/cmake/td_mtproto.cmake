@@ -27,6 +27,7 @@ PRIVATE
     mtproto/details/mtproto_dump_to_text.h
     mtproto/details/mtproto_received_ids_manager.cpp
     mtproto/details/mtproto_received_ids_manager.h
+    mtproto/details/mtproto_request_slots.h
     mtproto/details/mtproto_rsa_public_key.cpp
     mtproto/details/mtproto_rsa_public_key.h
     mtproto/details/mtproto_serialized_request.cpp